@@ -2,7 +2,7 @@
   "targets": [
     {
       "target_name": "tdlib",
-      "sources": ["tdlib_addon.cc"],
+      "sources": ["tdlib_addon.cc", "tdlib_client_table.cc", "tdlib_metrics.cc", "tdlib_receive_engine.cc", "tdlib_send_pacer.cc", "tdlib_update_filter.cc"],
       "cflags_cc": ["-std=c++17"],
       "include_dirs": [
         "<!(node -p \"require('node-addon-api').include\")"
@@ -1,10 +1,20 @@
 #include <napi.h>
 #include <string>
-#include <unordered_map>
 #include <mutex>
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+
+#include "tdlib_client_table.h"
+#include "tdlib_metrics.h"
+#include "tdlib_receive_engine.h"
+#include "tdlib_send_pacer.h"
+#include "tdlib_update_filter.h"
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -15,21 +25,26 @@
 #include <limits.h>
 #endif
 
-// TDLib C JSON interface signatures (declared manually to avoid header dependency)
-using td_json_client_create_t = void* (*)();
-using td_json_client_send_t = void (*)(void*, const char*);
-using td_json_client_receive_t = const char* (*)(void*, double);
-using td_json_client_execute_t = const char* (*)(void*, const char*);
-using td_json_client_destroy_t = void (*)(void*);
-
 struct TdJsonApi {
   void* handle{nullptr};
-  td_json_client_create_t create{nullptr};
-  td_json_client_send_t send{nullptr};
-  td_json_client_receive_t receive{nullptr};
-  td_json_client_execute_t execute{nullptr};
-  td_json_client_destroy_t destroy{nullptr};
-  bool initialized{false};
+  td_create_client_id_t create_client_id{nullptr};
+  td_send_t send{nullptr};
+  TdReceiveApi receive;
+  td_execute_t execute{nullptr};
+  td_set_scheduler_options_t set_scheduler_options{nullptr};
+  td_set_binlog_sync_delay_t set_binlog_sync_delay{nullptr};
+  td_set_deferred_message_search_indexing_t set_deferred_message_search_indexing{nullptr};
+  td_set_use_io_uring_t set_use_io_uring{nullptr};
+  td_set_use_ring_file_log_t set_use_ring_file_log{nullptr};
+  td_set_client_log_verbosity_level_t set_client_log_verbosity_level{nullptr};
+  td_set_heap_profile_sample_interval_t set_heap_profile_sample_interval{nullptr};
+  td_get_heap_profile_t get_heap_profile{nullptr};
+  td_set_use_object_arena_t set_use_object_arena{nullptr};
+  td_set_test_dc_server_t set_test_dc_server{nullptr};
+
+  // Set once all symbols are resolved; the function pointers are immutable
+  // afterwards, so the hot path reads them without locking
+  std::atomic<bool> initialized{false};
   
   // Thread-safe initialization flag
   std::mutex init_mutex;
@@ -37,13 +52,31 @@ struct TdJsonApi {
 
 // Global API instance with thread-safe access
 static TdJsonApi g_api;
-static std::mutex g_api_mutex;
 
-// Thread-safe client map
-static std::unordered_map<std::string, void*> g_clients;
-static std::mutex g_clients_mutex;
-static uint64_t g_clientCounter = 0;
-static std::mutex g_counter_mutex;
+// Clients created with td_create_client_id, indexed by their integer identifier
+static ClientTable g_clients;
+
+// Updates removed by per-client filters, by @type
+static UpdateFilterStats g_filter_stats;
+
+// Background receive engine
+static std::unique_ptr<ReceiveEngine> g_engine;
+static Napi::ThreadSafeFunction g_engine_tsfn;
+static std::mutex g_engine_mutex;
+
+// Releases paced sends of many accounts; the receive engine reports their
+// responses and outcome updates to it
+static SendPacer g_send_pacer;
+static Napi::ThreadSafeFunction g_send_pacer_tsfn;
+
+// Promises of invoke() requests awaiting their response. Only touched on the
+// JS thread; the receive engine refers to requests by identifier.
+struct PendingRequest {
+  Napi::Promise::Deferred deferred;
+  int32_t client_id;
+};
+static std::unordered_map<uint64_t, PendingRequest> g_pending_requests;
+static uint64_t g_next_request_id = 0;
 
 // Error codes
 enum class TdlibError {
@@ -74,6 +107,34 @@ static std::string get_error_message(TdlibError error, const std::string& detail
   }
 }
 
+static void reset_api() {
+  g_api.handle = nullptr;
+  g_api.create_client_id = nullptr;
+  g_api.send = nullptr;
+  g_api.receive = TdReceiveApi();
+  g_api.execute = nullptr;
+  g_api.set_scheduler_options = nullptr;
+  g_api.set_binlog_sync_delay = nullptr;
+  g_api.set_deferred_message_search_indexing = nullptr;
+  g_api.set_use_io_uring = nullptr;
+  g_api.set_use_ring_file_log = nullptr;
+  g_api.set_client_log_verbosity_level = nullptr;
+  g_api.set_heap_profile_sample_interval = nullptr;
+  g_api.get_heap_profile = nullptr;
+  g_api.set_use_object_arena = nullptr;
+  g_api.set_test_dc_server = nullptr;
+}
+
+static void* find_symbol(const char* name) {
+#ifdef _WIN32
+  return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(g_api.handle), name));
+#else
+  dlerror();
+  void* symbol = dlsym(g_api.handle, name);
+  return dlerror() == nullptr ? symbol : nullptr;
+#endif
+}
+
 static void load_tdjson(const std::string& path) {
   std::lock_guard<std::mutex> lock(g_api.init_mutex);
   
@@ -90,41 +151,6 @@ static void load_tdjson(const std::string& path) {
     std::string error_msg = "Windows error code: " + std::to_string(error);
     throw std::runtime_error(get_error_message(TdlibError::LIBRARY_NOT_LOADED, error_msg));
   }
-
-  g_api.create = reinterpret_cast<td_json_client_create_t>(GetProcAddress(static_cast<HMODULE>(g_api.handle), "td_json_client_create"));
-  if (!g_api.create) {
-    FreeLibrary(static_cast<HMODULE>(g_api.handle));
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_create"));
-  }
-
-  g_api.send = reinterpret_cast<td_json_client_send_t>(GetProcAddress(static_cast<HMODULE>(g_api.handle), "td_json_client_send"));
-  if (!g_api.send) {
-    FreeLibrary(static_cast<HMODULE>(g_api.handle));
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_send"));
-  }
-
-  g_api.receive = reinterpret_cast<td_json_client_receive_t>(GetProcAddress(static_cast<HMODULE>(g_api.handle), "td_json_client_receive"));
-  if (!g_api.receive) {
-    FreeLibrary(static_cast<HMODULE>(g_api.handle));
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_receive"));
-  }
-
-  g_api.execute = reinterpret_cast<td_json_client_execute_t>(GetProcAddress(static_cast<HMODULE>(g_api.handle), "td_json_client_execute"));
-  if (!g_api.execute) {
-    FreeLibrary(static_cast<HMODULE>(g_api.handle));
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_execute"));
-  }
-
-  g_api.destroy = reinterpret_cast<td_json_client_destroy_t>(GetProcAddress(static_cast<HMODULE>(g_api.handle), "td_json_client_destroy"));
-  if (!g_api.destroy) {
-    FreeLibrary(static_cast<HMODULE>(g_api.handle));
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_destroy"));
-  }
 #else
   // Unix/Linux: Use dlopen
   g_api.handle = dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL);
@@ -133,47 +159,53 @@ static void load_tdjson(const std::string& path) {
     std::string error_msg = dlerr ? std::string(dlerr) : "Unknown error";
     throw std::runtime_error(get_error_message(TdlibError::LIBRARY_NOT_LOADED, error_msg));
   }
+#endif
 
-  // Clear any previous errors
-  dlerror();
-
-  g_api.create = reinterpret_cast<td_json_client_create_t>(dlsym(g_api.handle, "td_json_client_create"));
-  if (dlerror() != nullptr) {
-    dlclose(g_api.handle);
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_create"));
-  }
-
-  g_api.send = reinterpret_cast<td_json_client_send_t>(dlsym(g_api.handle, "td_json_client_send"));
-  if (dlerror() != nullptr) {
-    dlclose(g_api.handle);
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_send"));
-  }
-
-  g_api.receive = reinterpret_cast<td_json_client_receive_t>(dlsym(g_api.handle, "td_json_client_receive"));
-  if (dlerror() != nullptr) {
-    dlclose(g_api.handle);
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_receive"));
-  }
+  // Multiplexed ClientManager interface: one receive loop serves every client
+  struct Symbol {
+    const char* name;
+    void** target;
+  };
+  const Symbol symbols[] = {
+    {"td_create_client_id", reinterpret_cast<void**>(&g_api.create_client_id)},
+    {"td_send", reinterpret_cast<void**>(&g_api.send)},
+    {"td_receive", reinterpret_cast<void**>(&g_api.receive.receive)},
+    {"td_execute", reinterpret_cast<void**>(&g_api.execute)},
+  };
 
-  g_api.execute = reinterpret_cast<td_json_client_execute_t>(dlsym(g_api.handle, "td_json_client_execute"));
-  if (dlerror() != nullptr) {
-    dlclose(g_api.handle);
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_execute"));
+  for (const auto& symbol : symbols) {
+    *symbol.target = find_symbol(symbol.name);
+    if (*symbol.target == nullptr) {
+#ifdef _WIN32
+      FreeLibrary(static_cast<HMODULE>(g_api.handle));
+#else
+      dlclose(g_api.handle);
+#endif
+      reset_api();
+      throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, symbol.name));
+    }
   }
 
-  g_api.destroy = reinterpret_cast<td_json_client_destroy_t>(dlsym(g_api.handle, "td_json_client_destroy"));
-  if (dlerror() != nullptr) {
-    dlclose(g_api.handle);
-    g_api = TdJsonApi{};
-    throw std::runtime_error(get_error_message(TdlibError::SYMBOL_NOT_FOUND, "td_json_client_destroy"));
-  }
-#endif
+  // Optional: spares measuring every response
+  g_api.receive.receive_with_length =
+      reinterpret_cast<td_receive_with_length_t>(find_symbol("td_receive_with_length"));
+  g_api.set_scheduler_options =
+      reinterpret_cast<td_set_scheduler_options_t>(find_symbol("td_set_scheduler_options"));
+  g_api.set_binlog_sync_delay =
+      reinterpret_cast<td_set_binlog_sync_delay_t>(find_symbol("td_set_binlog_sync_delay"));
+  g_api.set_deferred_message_search_indexing = reinterpret_cast<td_set_deferred_message_search_indexing_t>(
+      find_symbol("td_set_deferred_message_search_indexing"));
+  g_api.set_use_io_uring = reinterpret_cast<td_set_use_io_uring_t>(find_symbol("td_set_use_io_uring"));
+  g_api.set_use_ring_file_log = reinterpret_cast<td_set_use_ring_file_log_t>(find_symbol("td_set_use_ring_file_log"));
+  g_api.set_client_log_verbosity_level = reinterpret_cast<td_set_client_log_verbosity_level_t>(
+      find_symbol("td_set_client_log_verbosity_level"));
+  g_api.set_heap_profile_sample_interval = reinterpret_cast<td_set_heap_profile_sample_interval_t>(
+      find_symbol("td_set_heap_profile_sample_interval"));
+  g_api.get_heap_profile = reinterpret_cast<td_get_heap_profile_t>(find_symbol("td_get_heap_profile"));
+  g_api.set_use_object_arena = reinterpret_cast<td_set_use_object_arena_t>(find_symbol("td_set_use_object_arena"));
+  g_api.set_test_dc_server = reinterpret_cast<td_set_test_dc_server_t>(find_symbol("td_set_test_dc_server"));
 
-  g_api.initialized = true;
+  g_api.initialized.store(true, std::memory_order_release);
 }
 
 /**
@@ -316,7 +348,7 @@ static bool try_load_tdjson(const std::string& path) {
   HMODULE handle = LoadLibraryW(wpath.c_str());
   if (handle) {
     // Check if required symbols exist
-    void* create_sym = GetProcAddress(handle, "td_json_client_create");
+    void* create_sym = GetProcAddress(handle, "td_create_client_id");
     if (create_sym != nullptr) {
       // Library loaded successfully, close and return true
       // (We'll reload it properly in load_tdjson)
@@ -332,7 +364,7 @@ static bool try_load_tdjson(const std::string& path) {
     // Check if required symbols exist
     dlerror(); // Clear any previous errors
     
-    void* create_sym = dlsym(handle, "td_json_client_create");
+    void* create_sym = dlsym(handle, "td_create_client_id");
     if (dlerror() == nullptr && create_sym != nullptr) {
       // Library loaded successfully, close and return true
       // (We'll reload it properly in load_tdjson)
@@ -381,6 +413,78 @@ static std::string find_tdjson_library_path() {
   throw std::runtime_error(error_msg);
 }
 
+/**
+ * Load the library on first use
+ */
+static void ensure_tdjson_loaded() {
+  {
+    std::lock_guard<std::mutex> lock(g_api.init_mutex);
+    if (g_api.initialized) {
+      return;
+    }
+  }
+  load_tdjson(find_tdjson_library_path());
+}
+
+/**
+ * Look up a client that can still accept requests; returns nullptr if it is
+ * unknown or already closed
+ */
+static ClientState* find_client(int32_t client_id) {
+  ClientState* client = g_clients.get(client_id);
+  if (client == nullptr || client->status.load(std::memory_order_relaxed) == ClientState::Status::Closed) {
+    return nullptr;
+  }
+  return client;
+}
+
+/**
+ * Read a client identifier argument and look up its state without locking.
+ * Throws a JS exception and returns nullptr if the client is unknown or closed.
+ */
+static ClientState* get_client_arg(const Napi::Env& env, const Napi::Value& value) {
+  if (!value.IsNumber()) {
+    Napi::TypeError::New(env, "clientId (number) required").ThrowAsJavaScriptException();
+    return nullptr;
+  }
+
+  int32_t client_id = value.As<Napi::Number>().Int32Value();
+  ClientState* client = find_client(client_id);
+  if (client == nullptr) {
+    Napi::Error::New(env, get_error_message(TdlibError::CLIENT_NOT_FOUND, std::to_string(client_id)))
+        .ThrowAsJavaScriptException();
+    return nullptr;
+  }
+  return client;
+}
+
+/**
+ * Track client lifetime from a td_receive response and apply the client's
+ * update filter. Returns false if the response must not reach JS.
+ */
+static bool observe_response(const char* result, size_t size) {
+  int32_t client_id = get_response_client_id(result, size);
+  ClientState* client = g_clients.get(client_id);
+  if (client == nullptr) {
+    return true;
+  }
+  client->counters.add_received(result, size);
+  if (is_client_closed_update(result, size)) {
+    g_clients.mark_closed(client_id);
+  }
+
+  const UpdateFilter* filter = client->filter.load(std::memory_order_acquire);
+  if (filter == nullptr) {
+    return true;
+  }
+  std::string_view type = get_response_type(result, size);
+  if (filter->accepts(type)) {
+    return true;
+  }
+  g_filter_stats.add_dropped(type);
+  return false;
+}
+
 class CreateClientWorker : public Napi::AsyncWorker {
  public:
   CreateClientWorker(const Napi::Env& env, const Napi::Function& cb)
@@ -389,38 +493,15 @@ class CreateClientWorker : public Napi::AsyncWorker {
   void Execute() override {
     try {
       // Find library path with fallbacks
-      std::string libPath = find_tdjson_library_path();
-      
-      load_tdjson(libPath);
-
-      {
-        std::lock_guard<std::mutex> api_lock(g_api_mutex);
-        if (!g_api.create) {
-          SetError(get_error_message(TdlibError::LIBRARY_NOT_LOADED, "API not initialized"));
-          return;
-        }
-      }
+      ensure_tdjson_loaded();
 
-      void* client = nullptr;
-      {
-        std::lock_guard<std::mutex> api_lock(g_api_mutex);
-        client = g_api.create();
-      }
-      
-      if (!client) {
-        SetError(get_error_message(TdlibError::CLIENT_CREATE_FAILED, "td_json_client_create returned null"));
+      // The client itself is started by ClientManager on its first request
+      id = g_api.create_client_id();
+      if (g_clients.add(id) == nullptr) {
+        SetError(get_error_message(TdlibError::CLIENT_CREATE_FAILED,
+                                   "td_create_client_id returned invalid identifier " + std::to_string(id)));
         return;
       }
-
-      {
-        std::lock_guard<std::mutex> counter_lock(g_counter_mutex);
-        id = "tdc-" + std::to_string(++g_clientCounter);
-      }
-
-      {
-        std::lock_guard<std::mutex> clients_lock(g_clients_mutex);
-        g_clients[id] = client;
-      }
     } catch (const std::exception& ex) {
       SetError(ex.what());
     } catch (...) {
@@ -430,8 +511,8 @@ class CreateClientWorker : public Napi::AsyncWorker {
 
   void OnOK() override {
     Napi::HandleScope scope(Env());
-    Callback().Call({Env().Null(), Napi::String::New(Env(), id)});
-    deferred.Resolve(Napi::String::New(Env(), id));
+    Callback().Call({Env().Null(), Napi::Number::New(Env(), id)});
+    deferred.Resolve(Napi::Number::New(Env(), id));
   }
 
   void OnError(const Napi::Error& e) override {
@@ -443,7 +524,7 @@ class CreateClientWorker : public Napi::AsyncWorker {
   Napi::Promise GetPromise() const { return deferred.Promise(); }
 
  private:
-  std::string id;
+  int32_t id{0};
   Napi::Promise::Deferred deferred;
 };
 
@@ -461,35 +542,28 @@ Napi::Value CreateClient(const Napi::CallbackInfo& info) {
   return worker->GetPromise();
 }
 
+/**
+ * Ask a client to close. ClientManager destroys it asynchronously; the client
+ * is marked closed once its authorizationStateClosed update is received.
+ */
 Napi::Value DestroyClient(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 1 || !info[0].IsString()) {
-    Napi::TypeError::New(env, "clientId (string) required").ThrowAsJavaScriptException();
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "clientId (number) required").ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  const std::string clientId = info[0].As<Napi::String>().Utf8Value();
+  ClientState* client = get_client_arg(env, info[0]);
+  if (client == nullptr) {
+    return env.Null();
+  }
   
-  {
-    std::lock_guard<std::mutex> clients_lock(g_clients_mutex);
-    auto it = g_clients.find(clientId);
-    
-    if (it == g_clients.end()) {
-      Napi::Error::New(env, get_error_message(TdlibError::CLIENT_NOT_FOUND, clientId))
-          .ThrowAsJavaScriptException();
-      return env.Null();
-    }
-    
-    void* client = it->second;
-    g_clients.erase(it);
-    
-    {
-      std::lock_guard<std::mutex> api_lock(g_api_mutex);
-      if (g_api.destroy && client) {
-        g_api.destroy(client);
-      }
-    }
+  auto expected = ClientState::Status::Open;
+  if (client->status.compare_exchange_strong(expected, ClientState::Status::Closing, std::memory_order_acq_rel)) {
+    static const char kCloseRequest[] = "{\"@type\":\"close\"}";
+    client->counters.add_sent(1, sizeof(kCloseRequest) - 1);
+    g_api.send(client->id, kCloseRequest);
   }
   
   return env.Undefined();
@@ -498,51 +572,180 @@ Napi::Value DestroyClient(const Napi::CallbackInfo& info) {
 Napi::Value Send(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
-    Napi::TypeError::New(env, "clientId (string) and request (string) required")
+  if (info.Length() < 2 || !info[1].IsString()) {
+    Napi::TypeError::New(env, "clientId (number) and request (string) required")
         .ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  const std::string clientId = info[0].As<Napi::String>().Utf8Value();
+  ClientState* client = get_client_arg(env, info[0]);
+  if (client == nullptr) {
+    return env.Null();
+  }
+  
   const std::string request = info[1].As<Napi::String>().Utf8Value();
+  client->counters.add_sent(1, request.size());
+  g_api.send(client->id, request.c_str());
   
-  void* client = nullptr;
-  {
-    std::lock_guard<std::mutex> clients_lock(g_clients_mutex);
-    auto it = g_clients.find(clientId);
-    if (it == g_clients.end()) {
-      Napi::Error::New(env, get_error_message(TdlibError::CLIENT_NOT_FOUND, clientId))
-          .ThrowAsJavaScriptException();
-      return env.Null();
+  return env.Undefined();
+}
+
+/**
+ * Byte range of one request inside a newline-delimited Buffer
+ */
+struct RequestSpan {
+  size_t offset;
+  size_t size;
+};
+
+/**
+ * Split newline-delimited requests; empty lines and a trailing '\r' are skipped
+ */
+static std::vector<RequestSpan> split_requests(const char* data, size_t size) {
+  std::vector<RequestSpan> spans;
+  size_t begin = 0;
+  while (begin < size) {
+    const void* newline = std::memchr(data + begin, '\n', size - begin);
+    size_t end = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - data) : size;
+    size_t line_end = end;
+    if (line_end > begin && data[line_end - 1] == '\r') {
+      line_end--;
+    }
+    if (line_end > begin) {
+      spans.push_back(RequestSpan{begin, line_end - begin});
     }
-    client = it->second;
+    begin = end + 1;
   }
-  
-  {
-    std::lock_guard<std::mutex> api_lock(g_api_mutex);
-    if (!g_api.send) {
-      Napi::Error::New(env, get_error_message(TdlibError::LIBRARY_NOT_LOADED, "send function not available"))
+  return spans;
+}
+
+/**
+ * Submit many requests in one call.
+ *
+ * sendBatch(clientId, requests) sends every request to one client;
+ * sendBatch(clientIds, requests) takes an Int32Array with one client per
+ * request. requests is an array of strings or a Buffer of newline-delimited
+ * JSON. Buffer lines are copied into one reused string, so the Buffer is
+ * never written to. All clients are validated before anything is sent.
+ * Returns the number of requests sent.
+ */
+Napi::Value SendBatch(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !(info[0].IsNumber() || info[0].IsTypedArray()) ||
+      !(info[1].IsArray() || info[1].IsBuffer())) {
+    Napi::TypeError::New(env, "clientId (number or Int32Array) and requests (string[] or Buffer) required")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  std::vector<RequestSpan> spans;
+  Napi::Array strings;
+  const char* buffer_data = nullptr;
+  size_t buffer_size = 0;
+  size_t count = 0;
+  if (info[1].IsBuffer()) {
+    Napi::Buffer<char> buffer = info[1].As<Napi::Buffer<char>>();
+    buffer_data = buffer.Data();
+    buffer_size = buffer.Length();
+    spans = split_requests(buffer_data, buffer_size);
+    count = spans.size();
+  } else {
+    strings = info[1].As<Napi::Array>();
+    count = strings.Length();
+    for (uint32_t i = 0; i < count; ++i) {
+      if (!strings.Get(i).IsString()) {
+        Napi::TypeError::New(env, "requests[" + std::to_string(i) + "] must be a string")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
+  }
+
+  const int32_t* client_ids = nullptr;
+  ClientState* single_client = nullptr;
+  if (info[0].IsNumber()) {
+    single_client = get_client_arg(env, info[0]);
+    if (single_client == nullptr) {
+      return env.Null();
+    }
+  } else {
+    Napi::TypedArray typed_array = info[0].As<Napi::TypedArray>();
+    if (typed_array.TypedArrayType() != napi_int32_array) {
+      Napi::TypeError::New(env, "clientIds must be an Int32Array").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    Napi::Int32Array ids = typed_array.As<Napi::Int32Array>();
+    if (ids.ElementLength() != count) {
+      Napi::TypeError::New(env, "clientIds must have one entry per request (" + std::to_string(count) +
+                                    "), got " + std::to_string(ids.ElementLength()))
           .ThrowAsJavaScriptException();
       return env.Null();
     }
-    g_api.send(client, request.c_str());
+    client_ids = ids.Data();
+    for (size_t i = 0; i < count; ++i) {
+      if (find_client(client_ids[i]) == nullptr) {
+        Napi::Error::New(env, get_error_message(TdlibError::CLIENT_NOT_FOUND, std::to_string(client_ids[i])))
+            .ThrowAsJavaScriptException();
+        return env.Null();
+      }
+    }
   }
-  
-  return env.Undefined();
+
+  auto client_at = [&](size_t i) { return single_client != nullptr ? single_client->id : client_ids[i]; };
+  // A single client's counters are updated once for the whole batch
+  uint64_t single_client_bytes = 0;
+  auto count_sent = [&](size_t i, size_t size) {
+    if (single_client != nullptr) {
+      single_client_bytes += size;
+    } else {
+      g_clients.get(client_ids[i])->counters.add_sent(1, size);
+    }
+  };
+
+  // Reused across requests, so copying a line or converting a string does not allocate
+  std::string request;
+  if (buffer_data != nullptr) {
+    for (size_t i = 0; i < count; ++i) {
+      const RequestSpan& span = spans[i];
+      count_sent(i, span.size);
+      request.assign(buffer_data + span.offset, span.size);
+      g_api.send(client_at(i), request.c_str());
+    }
+  } else {
+    for (uint32_t i = 0; i < count; ++i) {
+      napi_value value = strings.Get(i);
+      size_t size = 0;
+      napi_status status = napi_get_value_string_utf8(env, value, nullptr, 0, &size);
+      NAPI_THROW_IF_FAILED(env, status, env.Null());
+      request.resize(size);
+      status = napi_get_value_string_utf8(env, value, &request[0], size + 1, &size);
+      NAPI_THROW_IF_FAILED(env, status, env.Null());
+      count_sent(i, size);
+      g_api.send(client_at(i), request.c_str());
+    }
+  }
+  if (single_client != nullptr) {
+    single_client->counters.add_sent(count, single_client_bytes);
+  }
+
+  return Napi::Number::New(env, static_cast<double>(count));
 }
 
+/**
+ * Receive the next response of any client; responses carry "@client_id".
+ * Only available while the receive engine is stopped.
+ */
 Napi::Value Receive(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   
-  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsNumber()) {
-    Napi::TypeError::New(env, "clientId (string) and timeout (number) required")
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "timeout (number) required")
         .ThrowAsJavaScriptException();
     return env.Null();
   }
   
-  const std::string clientId = info[0].As<Napi::String>().Utf8Value();
-  double timeout = info[1].As<Napi::Number>().DoubleValue();
+  double timeout = info[0].As<Napi::Number>().DoubleValue();
   
   // Validate timeout
   if (timeout < 0.0 || timeout > 300.0) {
@@ -551,34 +754,34 @@ Napi::Value Receive(const Napi::CallbackInfo& info) {
     return env.Null();
   }
   
-  void* client = nullptr;
   {
-    std::lock_guard<std::mutex> clients_lock(g_clients_mutex);
-    auto it = g_clients.find(clientId);
-    if (it == g_clients.end()) {
-      Napi::Error::New(env, get_error_message(TdlibError::CLIENT_NOT_FOUND, clientId))
+    auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+    if (g_engine) {
+      Napi::Error::New(env, "Receive engine is running; updates are delivered through its callback")
           .ThrowAsJavaScriptException();
       return env.Null();
     }
-    client = it->second;
   }
   
-  const char* result = nullptr;
-  {
-    std::lock_guard<std::mutex> api_lock(g_api_mutex);
-    if (!g_api.receive) {
-      Napi::Error::New(env, get_error_message(TdlibError::LIBRARY_NOT_LOADED, "receive function not available"))
-          .ThrowAsJavaScriptException();
-      return env.Null();
-    }
-    result = g_api.receive(client, timeout);
-  }
-  
-  if (!result) {
+  if (!g_api.initialized.load(std::memory_order_acquire)) {
+    // Nothing to receive before the first client is created
     return env.Null();
   }
   
-  return Napi::String::New(env, result);
+  // Filtered updates do not end the wait; keep receiving until the deadline
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+  for (;;) {
+    size_t size = 0;
+    const char* result = g_api.receive(timeout, size);
+    if (!result) {
+      return env.Null();
+    }
+    
+    if (observe_response(result, size)) {
+      return Napi::String::New(env, result, size);
+    }
+    timeout = std::max(0.0, std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count());
+  }
 }
 
 Napi::Value Execute(const Napi::CallbackInfo& info) {
@@ -591,17 +794,15 @@ Napi::Value Execute(const Napi::CallbackInfo& info) {
   
   const std::string request = info[0].As<Napi::String>().Utf8Value();
   
-  const char* result = nullptr;
-  {
-    std::lock_guard<std::mutex> api_lock(g_api_mutex);
-    if (!g_api.execute) {
-      Napi::Error::New(env, get_error_message(TdlibError::LIBRARY_NOT_LOADED, "execute function not available"))
-          .ThrowAsJavaScriptException();
-      return env.Null();
-    }
-    result = g_api.execute(nullptr, request.c_str());
+  try {
+    ensure_tdjson_loaded();
+  } catch (const std::exception& ex) {
+    Napi::Error::New(env, get_error_message(TdlibError::LIBRARY_NOT_LOADED, ex.what()))
+        .ThrowAsJavaScriptException();
+    return env.Null();
   }
   
+  const char* result = g_api.execute(request.c_str());
   if (!result) {
     return env.Null();
   }
@@ -609,25 +810,940 @@ Napi::Value Execute(const Napi::CallbackInfo& info) {
   return Napi::String::New(env, result);
 }
 
-Napi::Value GetLibraryInfo(const Napi::CallbackInfo& info) {
+static Napi::Error make_request_error(Napi::Env env, const std::string& message, const char* code) {
+  Napi::Error error = Napi::Error::New(env, message);
+  error.Set("code", Napi::String::New(env, code));
+  return error;
+}
+
+/**
+ * Settle the promise of an invoke() request. Runs on the main thread.
+ */
+static void settle_request(Napi::Env env, const ReceivedUpdate& item) {
+  auto it = g_pending_requests.find(item.request_id);
+  if (it == g_pending_requests.end()) {
+    return;
+  }
+  Napi::Promise::Deferred deferred = it->second.deferred;
+  int32_t client_id = it->second.client_id;
+  g_pending_requests.erase(it);
+
+  if (item.timed_out) {
+    deferred.Reject(make_request_error(env, "TDLib request timed out (client " + std::to_string(client_id) + ")",
+                                       "ETIMEDOUT").Value());
+  } else {
+    deferred.Resolve(Napi::String::New(env, item.data));
+  }
+}
+
+/**
+ * Reject pending invoke() requests with identifiers up to last_request_id.
+ * Runs on the main thread.
+ */
+static void reject_pending_requests(Napi::Env env, uint64_t last_request_id, const std::string& message) {
+  std::vector<Napi::Promise::Deferred> rejected;
+  for (auto it = g_pending_requests.begin(); it != g_pending_requests.end();) {
+    if (it->first <= last_request_id) {
+      rejected.push_back(it->second.deferred);
+      it = g_pending_requests.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (env == nullptr) {
+    return;
+  }
+  Napi::HandleScope scope(env);
+  for (auto& deferred : rejected) {
+    deferred.Reject(make_request_error(env, message, "ECANCELED").Value());
+  }
+}
+
+/**
+ * Settle responses to invoke() and hand the remaining updates to the JS
+ * callback. Runs on the main thread.
+ */
+static void deliver_update_batch(Napi::Env env, Napi::Function callback, UpdateBatch* data) {
+  std::unique_ptr<UpdateBatch> batch(data);
+  addon_metrics().queued_batches.fetch_sub(1, std::memory_order_relaxed);
+  addon_metrics().queued_updates.fetch_sub(batch->size(), std::memory_order_relaxed);
+  if (env == nullptr || callback == nullptr) {
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  Napi::Array updates = Napi::Array::New(env);
+  uint32_t count = 0;
+  for (const ReceivedUpdate& item : *batch) {
+    if (item.request_id != 0) {
+      settle_request(env, item);
+      continue;
+    }
+    Napi::Object update = Napi::Object::New(env);
+    update.Set("clientId", Napi::Number::New(env, item.client_id));
+    update.Set("update", Napi::String::New(env, item.data));
+    updates.Set(count++, update);
+  }
+  if (count == 0) {
+    return;
+  }
+
+  try {
+    callback.Call({updates});
+  } catch (const Napi::Error& e) {
+    e.ThrowAsJavaScriptException();
+  }
+}
+
+/**
+ * Runs on the main thread after the last batch of a stopped engine. Requests
+ * made after a restart have larger identifiers and are left alone.
+ */
+static void finish_receive_engine(Napi::Env env, Napi::Function /*callback*/, uint64_t* data) {
+  std::unique_ptr<uint64_t> last_request_id(data);
+  reject_pending_requests(env, *last_request_id, "TDLib receive engine stopped");
+}
+
+static void stop_receive_engine() {
+  std::unique_ptr<ReceiveEngine> engine;
+  {
+    auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+    engine = std::move(g_engine);
+  }
+  if (!engine) {
+    return;
+  }
+
+  // Joins the receive thread; batches flushed on the way out are still queued
+  // to the thread-safe function and delivered before it is finalized.
+  // Requests still pending after those batches are rejected.
+  engine->stop();
+  engine.reset();
+  auto* last_request_id = new uint64_t(g_next_request_id);
+  if (g_engine_tsfn.BlockingCall(last_request_id, finish_receive_engine) != napi_ok) {
+    delete last_request_id;
+    reject_pending_requests(nullptr, g_next_request_id, std::string());
+  }
+  g_engine_tsfn.Release();
+}
+
+static void stop_send_pacer();
+
+// Stops the background threads before the environment is torn down
+static void cleanup_hook(void* /*arg*/) {
+  stop_send_pacer();
+  stop_receive_engine();
+}
+
+static void add_cleanup_hook(Napi::Env env) {
+  static bool cleanup_hook_added = false;
+  if (!cleanup_hook_added) {
+    napi_add_env_cleanup_hook(env, cleanup_hook, nullptr);
+    cleanup_hook_added = true;
+  }
+}
+
+static size_t get_option(const Napi::Object& options, const char* name, size_t default_value) {
+  if (!options.Has(name)) {
+    return default_value;
+  }
+  Napi::Value value = options.Get(name);
+  if (!value.IsNumber()) {
+    throw Napi::TypeError::New(options.Env(), std::string(name) + " must be a number");
+  }
+  double number = value.As<Napi::Number>().DoubleValue();
+  if (number < 0) {
+    throw Napi::TypeError::New(options.Env(), std::string(name) + " must not be negative");
+  }
+  return static_cast<size_t>(number);
+}
+
+Napi::Value StartReceiveEngine(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ReceiveEngineOptions options;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object js_options = info[1].As<Napi::Object>();
+    options.max_batch_size = get_option(js_options, "maxBatchSize", options.max_batch_size);
+    options.flush_interval = std::chrono::milliseconds(
+        get_option(js_options, "flushIntervalMs", static_cast<size_t>(options.flush_interval.count())));
+    options.idle_timeout = std::chrono::milliseconds(
+        get_option(js_options, "idleTimeoutMs", static_cast<size_t>(options.idle_timeout.count())));
+  }
+
+  // The engine may be started before the first client is created
+  try {
+    ensure_tdjson_loaded();
+  } catch (const std::exception& ex) {
+    Napi::Error::New(env, ex.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+  if (g_engine) {
+    Napi::Error::New(env, "Receive engine is already running").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  g_engine_tsfn = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "tdlib-receive-engine", 0, 1);
+  Napi::ThreadSafeFunction tsfn = g_engine_tsfn;
+  auto sink = [tsfn](UpdateBatch&& batch) mutable {
+    auto* data = new UpdateBatch(std::move(batch));
+    size_t size = data->size();
+    addon_metrics().queued_batches.fetch_add(1, std::memory_order_relaxed);
+    addon_metrics().queued_updates.fetch_add(size, std::memory_order_relaxed);
+    if (tsfn.NonBlockingCall(data, deliver_update_batch) != napi_ok) {
+      delete data;
+      addon_metrics().queued_batches.fetch_sub(1, std::memory_order_relaxed);
+      addon_metrics().queued_updates.fetch_sub(size, std::memory_order_relaxed);
+    }
+  };
+  g_engine = std::make_unique<ReceiveEngine>(g_api.receive, g_clients, g_filter_stats, g_send_pacer, options,
+                                             std::move(sink));
+
+  g_engine->start();
+
+  add_cleanup_hook(env);
+
+  const ReceiveEngineOptions& actual = g_engine->options();
   Napi::Object result = Napi::Object::New(env);
-  
-  {
-    std::lock_guard<std::mutex> api_lock(g_api_mutex);
-    result.Set("initialized", Napi::Boolean::New(env, g_api.initialized));
-    result.Set("handle", Napi::Number::New(env, reinterpret_cast<uintptr_t>(g_api.handle)));
-    result.Set("hasCreate", Napi::Boolean::New(env, g_api.create != nullptr));
-    result.Set("hasSend", Napi::Boolean::New(env, g_api.send != nullptr));
-    result.Set("hasReceive", Napi::Boolean::New(env, g_api.receive != nullptr));
-    result.Set("hasExecute", Napi::Boolean::New(env, g_api.execute != nullptr));
-    result.Set("hasDestroy", Napi::Boolean::New(env, g_api.destroy != nullptr));
+  result.Set("maxBatchSize", Napi::Number::New(env, static_cast<double>(actual.max_batch_size)));
+  result.Set("flushIntervalMs", Napi::Number::New(env, static_cast<double>(actual.flush_interval.count())));
+  result.Set("idleTimeoutMs", Napi::Number::New(env, static_cast<double>(actual.idle_timeout.count())));
+  return result;
+}
+
+/**
+ * invoke(clientId, request, timeoutMs?) sends a request and returns a promise
+ * for its raw response string. The addon tags the request with its own
+ * "@extra" (requests with their own "@extra" are rejected), and the receive
+ * engine, which must be running, matches the response and enforces the
+ * timeout. Timeouts reject with code ETIMEDOUT, stopping the
+ * engine rejects outstanding requests with code ECANCELED.
+ */
+Napi::Value Invoke(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[1].IsString() || (info.Length() >= 3 && !info[2].IsNumber() &&
+                                                   !info[2].IsUndefined())) {
+    Napi::TypeError::New(env, "clientId (number), request (string) and optional timeoutMs (number) required")
+        .ThrowAsJavaScriptException();
+    return env.Null();
   }
+
+  ClientState* client = get_client_arg(env, info[0]);
+  if (client == nullptr) {
+    return env.Null();
+  }
+
+  double timeout_ms = 30000;
+  if (info.Length() >= 3 && info[2].IsNumber()) {
+    timeout_ms = info[2].As<Napi::Number>().DoubleValue();
+    if (!(timeout_ms > 0 && timeout_ms <= 300000)) {
+      Napi::TypeError::New(env, "timeoutMs must be between 0 and 300000").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  const std::string request = info[1].As<Napi::String>().Utf8Value();
+  if (has_extra(request.data(), request.size())) {
+    Napi::TypeError::New(env, "request must not contain \"@extra\"").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  uint64_t request_id = ++g_next_request_id;
+  const std::string tagged = make_invoke_request(request.data(), request.size(), request_id);
+
+  {
+    auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+    if (!g_engine) {
+      Napi::Error::New(env, "invoke requires the receive engine to be running").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    g_engine->track_request(request_id, std::chrono::steady_clock::now() +
+                                            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                std::chrono::duration<double, std::milli>(timeout_ms)));
+  }
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+  g_pending_requests.emplace(request_id, PendingRequest{deferred, client->id});
+  client->counters.add_sent(1, tagged.size());
+  g_api.send(client->id, tagged.c_str());
+  return deferred.Promise();
+}
+
+Napi::Value StopReceiveEngine(const Napi::CallbackInfo& info) {
+  stop_receive_engine();
+  return info.Env().Undefined();
+}
+
+static const char* get_paced_send_status_name(PacedSendResult::Status status) {
+  switch (status) {
+    case PacedSendResult::Status::Sent:
+      return "sent";
+    case PacedSendResult::Status::Failed:
+      return "failed";
+    case PacedSendResult::Status::TimedOut:
+      return "timedOut";
+    case PacedSendResult::Status::Cancelled:
+      return "cancelled";
+  }
+  return "unknown";
+}
+
+/**
+ * Hand a batch of paced send results to the JS callback. Runs on the main thread.
+ */
+static void deliver_paced_send_results(Napi::Env env, Napi::Function callback, PacedSendResultBatch* data) {
+  std::unique_ptr<PacedSendResultBatch> batch(data);
+  if (env == nullptr || callback == nullptr) {
+    return;
+  }
+
+  Napi::HandleScope scope(env);
+  Napi::Array results = Napi::Array::New(env, batch->size());
+  uint32_t count = 0;
+  for (const PacedSendResult& item : *batch) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("batchId", Napi::Number::New(env, static_cast<double>(item.batch_id)));
+    result.Set("index", Napi::Number::New(env, item.index));
+    result.Set("clientId", Napi::Number::New(env, item.client_id));
+    result.Set("status", Napi::String::New(env, get_paced_send_status_name(item.status)));
+    result.Set("attempts", Napi::Number::New(env, item.attempts));
+    if (item.status == PacedSendResult::Status::Sent) {
+      result.Set("response", Napi::String::New(env, item.data));
+    } else if (item.status == PacedSendResult::Status::Failed) {
+      result.Set("errorCode", Napi::Number::New(env, item.error_code));
+      result.Set("errorMessage", Napi::String::New(env, item.data));
+    }
+    results.Set(count++, result);
+  }
+
+  try {
+    callback.Call({results});
+  } catch (const Napi::Error& e) {
+    e.ThrowAsJavaScriptException();
+  }
+}
+
+static void stop_send_pacer() {
+  if (!g_send_pacer.is_running()) {
+    return;
+  }
+  // Unfinished sends are reported as cancelled before the function is released
+  g_send_pacer.stop();
+  g_send_pacer_tsfn.Release();
+}
+
+/**
+ * startSendPacer(callback, options?) starts the pacer thread, which releases
+ * sends queued by enqueueSends and calls callback(results) with batches of
+ * { batchId, index, clientId, status, attempts, response?, errorCode?, errorMessage? },
+ * where status is 'sent', 'failed', 'timedOut' or 'cancelled'.
+ * Options: maxInFlight, timeoutMs, maxRetries, maxBatchSize, flushIntervalMs.
+ */
+Napi::Value StartSendPacer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  SendPacerOptions options;
+  if (info.Length() >= 2 && info[1].IsObject()) {
+    Napi::Object js_options = info[1].As<Napi::Object>();
+    options.max_in_flight = get_option(js_options, "maxInFlight", options.max_in_flight);
+    options.send_timeout = std::chrono::milliseconds(
+        get_option(js_options, "timeoutMs", static_cast<size_t>(options.send_timeout.count())));
+    options.max_retries =
+        static_cast<int32_t>(get_option(js_options, "maxRetries", static_cast<size_t>(options.max_retries)));
+    options.max_batch_size = get_option(js_options, "maxBatchSize", options.max_batch_size);
+    options.flush_interval = std::chrono::milliseconds(
+        get_option(js_options, "flushIntervalMs", static_cast<size_t>(options.flush_interval.count())));
+  }
+
+  try {
+    ensure_tdjson_loaded();
+  } catch (const std::exception& ex) {
+    Napi::Error::New(env, ex.what()).ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  if (g_send_pacer.is_running()) {
+    Napi::Error::New(env, "Send pacer is already running").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  g_send_pacer_tsfn = Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "tdlib-send-pacer", 0, 1);
+  Napi::ThreadSafeFunction tsfn = g_send_pacer_tsfn;
+  auto send = [](int32_t client_id, const std::string& request) {
+    // A closed client gets an error response from TDLib, which fails the send
+    ClientState* client = find_client(client_id);
+    if (client != nullptr) {
+      client->counters.add_sent(1, request.size());
+    }
+    g_api.send(client_id, request.c_str());
+  };
+  auto sink = [tsfn](PacedSendResultBatch&& batch) mutable {
+    auto* data = new PacedSendResultBatch(std::move(batch));
+    if (tsfn.NonBlockingCall(data, deliver_paced_send_results) != napi_ok) {
+      delete data;
+    }
+  };
+  g_send_pacer.start(send, options, std::move(sink));
+
+  add_cleanup_hook(env);
+
+  const SendPacerOptions& actual = g_send_pacer.options();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("maxInFlight", Napi::Number::New(env, static_cast<double>(actual.max_in_flight)));
+  result.Set("timeoutMs", Napi::Number::New(env, static_cast<double>(actual.send_timeout.count())));
+  result.Set("maxRetries", Napi::Number::New(env, actual.max_retries));
+  result.Set("maxBatchSize", Napi::Number::New(env, static_cast<double>(actual.max_batch_size)));
+  result.Set("flushIntervalMs", Napi::Number::New(env, static_cast<double>(actual.flush_interval.count())));
+  return result;
+}
+
+Napi::Value StopSendPacer(const Napi::CallbackInfo& info) {
+  stop_send_pacer();
+  return info.Env().Undefined();
+}
+
+/**
+ * enqueueSends(clientId, requests, pacing?) queues requests of one account and
+ * returns their batch identifier. Requests with their own "@extra" are
+ * rejected; the pacer tags them itself. Pacing { ratePerSecond, burst } replaces the send
+ * rate of the account. Requires both the receive engine and the send pacer.
+ */
+Napi::Value EnqueueSends(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "clientId (number), requests (string[]) and optional pacing (object) required")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ClientState* client = get_client_arg(env, info[0]);
+  if (client == nullptr) {
+    return env.Null();
+  }
+
+  Napi::Array js_requests = info[1].As<Napi::Array>();
+  std::vector<std::string> requests;
+  requests.reserve(js_requests.Length());
+  for (uint32_t i = 0; i < js_requests.Length(); i++) {
+    Napi::Value value = js_requests.Get(i);
+    if (!value.IsString()) {
+      Napi::TypeError::New(env, "requests must contain only strings").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    requests.push_back(value.As<Napi::String>().Utf8Value());
+    if (has_extra(requests.back().data(), requests.back().size())) {
+      Napi::TypeError::New(env, "requests must not contain \"@extra\"").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  SendPacing pacing;
+  bool has_pacing = info.Length() >= 3 && info[2].IsObject();
+  if (has_pacing) {
+    Napi::Object js_pacing = info[2].As<Napi::Object>();
+    Napi::Value rate = js_pacing.Get("ratePerSecond");
+    if (!rate.IsNumber() || !(rate.As<Napi::Number>().DoubleValue() > 0)) {
+      Napi::TypeError::New(env, "ratePerSecond must be a positive number").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    pacing.rate = rate.As<Napi::Number>().DoubleValue();
+    Napi::Value burst = js_pacing.Get("burst");
+    if (burst.IsNumber()) {
+      pacing.burst = burst.As<Napi::Number>().DoubleValue();
+    }
+  }
+
+  {
+    auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+    if (!g_engine || !g_send_pacer.is_running()) {
+      Napi::Error::New(env, "enqueueSends requires the receive engine and the send pacer to be running")
+          .ThrowAsJavaScriptException();
+      return env.Null();
+    }
+  }
+
+  uint64_t batch_id = g_send_pacer.enqueue(client->id, std::move(requests), has_pacing ? &pacing : nullptr);
+  return Napi::Number::New(env, static_cast<double>(batch_id));
+}
+
+/**
+ * cancelSends(batchId) drops the sends of a batch that are not released yet
+ * and returns their number; they are reported as cancelled
+ */
+Napi::Value CancelSends(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "batchId (number) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  auto batch_id = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+  return Napi::Number::New(env, static_cast<double>(g_send_pacer.cancel(batch_id)));
+}
+
+/**
+ * Per-account pacer state:
+ * [{ clientId, queued, inFlight, ratePerSecond, pausedForMs, sent, failed, floodWaits }]
+ */
+Napi::Value GetSendPacerStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<SendPacerAccountStats> stats = g_send_pacer.get_stats();
+  Napi::Array result = Napi::Array::New(env, stats.size());
+  for (size_t i = 0; i < stats.size(); i++) {
+    const SendPacerAccountStats& account = stats[i];
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("clientId", Napi::Number::New(env, account.client_id));
+    item.Set("queued", Napi::Number::New(env, static_cast<double>(account.queued)));
+    item.Set("inFlight", Napi::Number::New(env, static_cast<double>(account.in_flight)));
+    item.Set("ratePerSecond", Napi::Number::New(env, account.rate));
+    item.Set("pausedForMs", Napi::Number::New(env, static_cast<double>(account.paused_for.count())));
+    item.Set("sent", Napi::Number::New(env, static_cast<double>(account.sent)));
+    item.Set("failed", Napi::Number::New(env, static_cast<double>(account.failed)));
+    item.Set("floodWaits", Napi::Number::New(env, static_cast<double>(account.flood_waits)));
+    result.Set(static_cast<uint32_t>(i), item);
+  }
+  return result;
+}
+
+static std::vector<std::string> get_string_list(const Napi::Object& options, const char* name) {
+  std::vector<std::string> result;
+  if (!options.Has(name)) {
+    return result;
+  }
+  Napi::Value value = options.Get(name);
+  if (!value.IsArray()) {
+    throw Napi::TypeError::New(options.Env(), std::string(name) + " must be an array of strings");
+  }
+  Napi::Array array = value.As<Napi::Array>();
+  result.reserve(array.Length());
+  for (uint32_t i = 0; i < array.Length(); ++i) {
+    Napi::Value item = array.Get(i);
+    if (!item.IsString()) {
+      throw Napi::TypeError::New(options.Env(), std::string(name) + " must be an array of strings");
+    }
+    result.push_back(item.As<Napi::String>().Utf8Value());
+  }
+  return result;
+}
+
+/**
+ * setUpdateFilter(clientId, { mode: 'allow' | 'deny', types, coalesce? })
+ * installs a client's update filter; setUpdateFilter(clientId, null) removes it.
+ */
+Napi::Value SetUpdateFilter(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !(info[1].IsObject() || info[1].IsNull() || info[1].IsUndefined())) {
+    Napi::TypeError::New(env, "clientId (number) and filter (object or null) required")
+        .ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  ClientState* client = get_client_arg(env, info[0]);
+  if (client == nullptr) {
+    return env.Null();
+  }
+
+  if (!info[1].IsObject()) {
+    g_clients.set_filter(*client, nullptr);
+    return env.Undefined();
+  }
+
+  Napi::Object options = info[1].As<Napi::Object>();
+  std::string mode = options.Has("mode") && options.Get("mode").IsString()
+                         ? options.Get("mode").As<Napi::String>().Utf8Value()
+                         : "";
+  if (mode != "allow" && mode != "deny") {
+    Napi::TypeError::New(env, "filter.mode must be 'allow' or 'deny'").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto filter = std::make_unique<UpdateFilter>(mode == "allow" ? UpdateFilter::Mode::Allow : UpdateFilter::Mode::Deny,
+                                               get_string_list(options, "types"),
+                                               get_string_list(options, "coalesce"));
+  g_clients.set_filter(*client, std::move(filter));
+  return env.Undefined();
+}
+
+static bool get_bool_option(const Napi::Object& options, const char* name, bool default_value) {
+  if (!options.Has(name)) {
+    return default_value;
+  }
+  Napi::Value value = options.Get(name);
+  if (!value.IsBoolean()) {
+    throw Napi::TypeError::New(options.Env(), std::string(name) + " must be a boolean");
+  }
+  return value.As<Napi::Boolean>().Value();
+}
+
+/**
+ * Load libtdjson and return one of the functions only some TDLib builds export, or nullptr if the loaded
+ * library lacks it. The setters below return false and the getters null in that case.
+ */
+template <class FunctionT>
+static FunctionT get_optional_function(Napi::Env env, FunctionT TdJsonApi::*function) {
+  try {
+    ensure_tdjson_loaded();
+  } catch (const std::exception& ex) {
+    throw Napi::Error::New(env, get_error_message(TdlibError::LIBRARY_NOT_LOADED, ex.what()));
+  }
+  return g_api.*function;
+}
+
+/**
+ * Pass the only argument of setX(enabled) to a libtdjson setter taking a 0/1 flag
+ */
+template <class SetterT>
+static Napi::Value call_flag_setter(const Napi::CallbackInfo& info, SetterT TdJsonApi::*setter) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsBoolean()) {
+    Napi::TypeError::New(env, "enabled (boolean) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  bool is_enabled = info[0].As<Napi::Boolean>().Value();
+
+  auto set_flag = get_optional_function(env, setter);
+  if (set_flag == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+  set_flag(is_enabled ? 1 : 0);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Configure TDLib's scheduler pool: setSchedulerOptions({ instances, threadsPerInstance, pinThreads, loadAware }).
+ * Takes effect when the pool is created, i.e. before the first request is sent.
+ */
+Napi::Value SetSchedulerOptions(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "options (object) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto set_scheduler_options = get_optional_function(env, &TdJsonApi::set_scheduler_options);
+  if (set_scheduler_options == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  Napi::Object options = info[0].As<Napi::Object>();
+  auto instance_count = static_cast<int>(std::min<size_t>(get_option(options, "instances", 0), 1024));
+  auto thread_count = static_cast<int>(std::min<size_t>(get_option(options, "threadsPerInstance", 0), 1024));
+  bool pin_threads = get_bool_option(options, "pinThreads", false);
+  bool load_aware = get_bool_option(options, "loadAware", true);
+  set_scheduler_options(instance_count, thread_count, pin_threads ? 1 : 0, load_aware ? 1 : 0);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Sync binlogs of all clients together: setBinlogSyncDelay(maxDelayMs). Syncs requested within maxDelayMs are
+ * batched on shared threads; 0 restores independent syncs.
+ */
+Napi::Value SetBinlogSyncDelay(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "maxDelayMs (number) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  double max_delay_ms = info[0].As<Napi::Number>().DoubleValue();
+  if (!(max_delay_ms >= 0 && max_delay_ms <= 1000)) {
+    Napi::RangeError::New(env, "maxDelayMs must be between 0 and 1000").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+
+  auto set_binlog_sync_delay = get_optional_function(env, &TdJsonApi::set_binlog_sync_delay);
+  if (set_binlog_sync_delay == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+  set_binlog_sync_delay(max_delay_ms / 1000.0);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Index messages for search in background batches: setDeferredMessageSearchIndexing(enabled). Applies to clients
+ * created afterwards.
+ */
+Napi::Value SetDeferredMessageSearchIndexing(const Napi::CallbackInfo& info) {
+  return call_flag_setter(info, &TdJsonApi::set_deferred_message_search_indexing);
+}
+
+/**
+ * Wait for network events with io_uring instead of epoll: setUseIoUring(enabled). Applies to client threads started
+ * afterwards; epoll is kept if the kernel lacks io_uring.
+ */
+Napi::Value SetUseIoUring(const Napi::CallbackInfo& info) {
+  return call_flag_setter(info, &TdJsonApi::set_use_io_uring);
+}
+
+/**
+ * Write TDLib log files from a background thread fed by per-thread lock-free buffers: setUseRingFileLog(enabled).
+ * Applies to log files set by setLogStream afterwards.
+ */
+Napi::Value SetUseRingFileLog(const Napi::CallbackInfo& info) {
+  return call_flag_setter(info, &TdJsonApi::set_use_ring_file_log);
+}
+
+/**
+ * Log one client above the global verbosity: setClientLogVerbosityLevel(clientId, level). A negative level restores
+ * the global verbosity for the client.
+ */
+Napi::Value SetClientLogVerbosityLevel(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber()) {
+    Napi::TypeError::New(env, "clientId (number) and level (number) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  int client_id = info[0].As<Napi::Number>().Int32Value();
+  int level = info[1].As<Napi::Number>().Int32Value();
+
+  auto set_client_log_verbosity_level = get_optional_function(env, &TdJsonApi::set_client_log_verbosity_level);
+  if (set_client_log_verbosity_level == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+  set_client_log_verbosity_level(client_id, level);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Sample one TDLib allocation per the given number of allocated bytes on average: setHeapProfileSampleInterval(bytes).
+ * 0 disables sampling.
+ */
+Napi::Value SetHeapProfileSampleInterval(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().DoubleValue() < 0) {
+    Napi::TypeError::New(env, "bytes (non-negative number) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  auto sample_interval = static_cast<size_t>(info[0].As<Napi::Number>().Int64Value());
+
+  auto set_heap_profile_sample_interval =
+      get_optional_function(env, &TdJsonApi::set_heap_profile_sample_interval);
+  if (set_heap_profile_sample_interval == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+  set_heap_profile_sample_interval(sample_interval);
+  return Napi::Boolean::New(env, true);
+}
+
+/**
+ * Heap profile of sampled allocations of one client or of the whole process in pprof-compatible text format:
+ * getHeapProfile(clientId = 0). The profile is empty unless TDLib is built with MEMPROF=SAMPLE.
+ */
+Napi::Value GetHeapProfile(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  int client_id = 0;
+  if (info.Length() >= 1 && !info[0].IsUndefined()) {
+    if (!info[0].IsNumber()) {
+      Napi::TypeError::New(env, "clientId must be a number").ThrowAsJavaScriptException();
+      return env.Null();
+    }
+    client_id = info[0].As<Napi::Number>().Int32Value();
+  }
+
+  auto get_heap_profile = get_optional_function(env, &TdJsonApi::get_heap_profile);
+  if (get_heap_profile == nullptr) {
+    return env.Null();
+  }
+  const char* profile = get_heap_profile(client_id);
+  return Napi::String::New(env, profile == nullptr ? "" : profile);
+}
+
+/**
+ * Allocate TDLib objects of responses and updates from per-thread memory chunks: setUseObjectArena(enabled).
+ * Applies to objects created afterwards. A 64 KB chunk is freed after all of its objects, so every object kept
+ * by TDLib for a long time can keep up to 64 KB in memory.
+ */
+Napi::Value SetUseObjectArena(const Napi::CallbackInfo& info) {
+  return call_flag_setter(info, &TdJsonApi::set_use_object_arena);
+}
+
+/**
+ * Redirect clients using test data centers to a local server: setTestDcServer(address, publicRsaKeyPem).
+ * Applies to clients created afterwards; an empty address restores Telegram test servers. Returns false
+ * also if libtdjson rejects the address or the key.
+ */
+Napi::Value SetTestDcServer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "address (string) and publicRsaKey (string) required").ThrowAsJavaScriptException();
+    return env.Null();
+  }
+  std::string address = info[0].As<Napi::String>().Utf8Value();
+  std::string public_rsa_key = info[1].As<Napi::String>().Utf8Value();
+
+  auto set_test_dc_server = get_optional_function(env, &TdJsonApi::set_test_dc_server);
+  if (set_test_dc_server == nullptr) {
+    return Napi::Boolean::New(env, false);
+  }
+  return Napi::Boolean::New(env, set_test_dc_server(address.c_str(), public_rsa_key.c_str()) != 0);
+}
+
+/**
+ * Counters of filtered updates: { [type]: { dropped, coalesced } }
+ */
+Napi::Value GetUpdateFilterStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object result = Napi::Object::New(env);
+  for (const auto& entry : g_filter_stats.snapshot()) {
+    Napi::Object counters = Napi::Object::New(env);
+    counters.Set("dropped", Napi::Number::New(env, static_cast<double>(entry.second.dropped)));
+    counters.Set("coalesced", Napi::Number::New(env, static_cast<double>(entry.second.coalesced)));
+    result.Set(entry.first, counters);
+  }
+  return result;
+}
+
+static const char* get_status_name(ClientState::Status status) {
+  switch (status) {
+    case ClientState::Status::Open:
+      return "open";
+    case ClientState::Status::Closing:
+      return "closing";
+    case ClientState::Status::Closed:
+      return "closed";
+    default:
+      return "unknown";
+  }
+}
+
+struct CounterValues {
+  uint64_t requests_sent{0};
+  uint64_t responses_received{0};
+  uint64_t updates_received{0};
+  uint64_t bytes_sent{0};
+  uint64_t bytes_received{0};
+};
+
+static Napi::Object make_counters_object(Napi::Env env, const CounterValues& values) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("requestsSent", Napi::Number::New(env, static_cast<double>(values.requests_sent)));
+  result.Set("responsesReceived", Napi::Number::New(env, static_cast<double>(values.responses_received)));
+  result.Set("updatesReceived", Napi::Number::New(env, static_cast<double>(values.updates_received)));
+  result.Set("bytesSent", Napi::Number::New(env, static_cast<double>(values.bytes_sent)));
+  result.Set("bytesReceived", Napi::Number::New(env, static_cast<double>(values.bytes_received)));
+  return result;
+}
+
+static Napi::Object make_histogram_object(Napi::Env env, const LatencyHistogram& histogram) {
+  LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+  auto micros = [&](uint64_t ns) { return Napi::Number::New(env, static_cast<double>(ns) / 1000.0); };
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, static_cast<double>(snapshot.count)));
+  result.Set("sumUs", micros(snapshot.sum_ns));
+  result.Set("maxUs", micros(snapshot.max_ns));
+  result.Set("p50Us", micros(snapshot.value_at(0.5)));
+  result.Set("p90Us", micros(snapshot.value_at(0.9)));
+  result.Set("p99Us", micros(snapshot.value_at(0.99)));
+  result.Set("p999Us", micros(snapshot.value_at(0.999)));
+  return result;
+}
+
+/**
+ * Snapshot of the hot-path instrumentation: per-client traffic counters and
+ * their totals, invoke() response latency, lock wait times, requests awaiting
+ * a response and batches waiting for the JS thread. Counters are read with
+ * relaxed loads, so the values are consistent per field, not across fields.
+ */
+Napi::Value GetMetrics(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object result = Napi::Object::New(env);
+
+  CounterValues totals;
+  Napi::Array clients = Napi::Array::New(env);
+  uint32_t client_count = 0;
+  g_clients.for_each([&](const ClientState& client) {
+    CounterValues values;
+    values.requests_sent = client.counters.requests_sent.load(std::memory_order_relaxed);
+    values.responses_received = client.counters.responses_received.load(std::memory_order_relaxed);
+    values.updates_received = client.counters.updates_received.load(std::memory_order_relaxed);
+    values.bytes_sent = client.counters.bytes_sent.load(std::memory_order_relaxed);
+    values.bytes_received = client.counters.bytes_received.load(std::memory_order_relaxed);
+    totals.requests_sent += values.requests_sent;
+    totals.responses_received += values.responses_received;
+    totals.updates_received += values.updates_received;
+    totals.bytes_sent += values.bytes_sent;
+    totals.bytes_received += values.bytes_received;
+
+    Napi::Object entry = make_counters_object(env, values);
+    entry.Set("clientId", Napi::Number::New(env, client.id));
+    entry.Set("status", Napi::String::New(env, get_status_name(client.status.load(std::memory_order_relaxed))));
+    clients.Set(client_count++, entry);
+  });
+  result.Set("clients", clients);
+  result.Set("totals", make_counters_object(env, totals));
+
+  result.Set("pendingRequests", Napi::Number::New(env, static_cast<double>(g_pending_requests.size())));
+  Napi::Object backlog = Napi::Object::New(env);
+  backlog.Set("batches", Napi::Number::New(env, static_cast<double>(
+                                                    addon_metrics().queued_batches.load(std::memory_order_relaxed))));
+  backlog.Set("updates", Napi::Number::New(env, static_cast<double>(
+                                                    addon_metrics().queued_updates.load(std::memory_order_relaxed))));
+  result.Set("deliveryBacklog", backlog);
+
+  result.Set("responseLatency", make_histogram_object(env, addon_metrics().response_latency));
+  Napi::Object lock_wait = Napi::Object::New(env);
+  for (size_t i = 0; i < addon_metrics().lock_wait.size(); ++i) {
+    lock_wait.Set(get_lock_name(static_cast<AddonLock>(i)), make_histogram_object(env, addon_metrics().lock_wait[i]));
+  }
+  result.Set("lockWait", lock_wait);
+  return result;
+}
+
+Napi::Value GetLibraryInfo(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  Napi::Object result = Napi::Object::New(env);
+  
+  {
+    std::lock_guard<std::mutex> api_lock(g_api.init_mutex);
+    result.Set("initialized", Napi::Boolean::New(env, g_api.initialized));
+    result.Set("handle", Napi::Number::New(env, reinterpret_cast<uintptr_t>(g_api.handle)));
+    result.Set("hasCreate", Napi::Boolean::New(env, g_api.create_client_id != nullptr));
+    result.Set("hasSend", Napi::Boolean::New(env, g_api.send != nullptr));
+    result.Set("hasReceive", Napi::Boolean::New(env, g_api.receive.receive != nullptr));
+    result.Set("hasReceiveWithLength", Napi::Boolean::New(env, g_api.receive.receive_with_length != nullptr));
+    result.Set("hasExecute", Napi::Boolean::New(env, g_api.execute != nullptr));
+    result.Set("hasSchedulerOptions", Napi::Boolean::New(env, g_api.set_scheduler_options != nullptr));
+    result.Set("hasBinlogSyncDelay", Napi::Boolean::New(env, g_api.set_binlog_sync_delay != nullptr));
+    result.Set("hasDeferredMessageSearchIndexing",
+               Napi::Boolean::New(env, g_api.set_deferred_message_search_indexing != nullptr));
+    result.Set("hasUseIoUring", Napi::Boolean::New(env, g_api.set_use_io_uring != nullptr));
+    result.Set("hasUseRingFileLog", Napi::Boolean::New(env, g_api.set_use_ring_file_log != nullptr));
+    result.Set("hasClientLogVerbosityLevel",
+               Napi::Boolean::New(env, g_api.set_client_log_verbosity_level != nullptr));
+    result.Set("hasHeapProfile", Napi::Boolean::New(env, g_api.get_heap_profile != nullptr));
+    result.Set("hasUseObjectArena", Napi::Boolean::New(env, g_api.set_use_object_arena != nullptr));
+    result.Set("hasTestDcServer", Napi::Boolean::New(env, g_api.set_test_dc_server != nullptr));
+    // Clients are destroyed by sending them a close request
+    result.Set("hasDestroy", Napi::Boolean::New(env, g_api.send != nullptr));
+  }
+  
+  result.Set("clientCount", Napi::Number::New(env, static_cast<double>(g_clients.open_count())));
   
   {
-    std::lock_guard<std::mutex> clients_lock(g_clients_mutex);
-    result.Set("clientCount", Napi::Number::New(env, g_clients.size()));
+    auto engine_lock = lock_timed(g_engine_mutex, AddonLock::Engine);
+    result.Set("receiveEngineRunning", Napi::Boolean::New(env, g_engine != nullptr));
   }
+  result.Set("sendPacerRunning", Napi::Boolean::New(env, g_send_pacer.is_running()));
   
   return result;
 }
@@ -636,8 +1752,33 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set(Napi::String::New(env, "createClient"), Napi::Function::New(env, CreateClient));
   exports.Set(Napi::String::New(env, "destroyClient"), Napi::Function::New(env, DestroyClient));
   exports.Set(Napi::String::New(env, "send"), Napi::Function::New(env, Send));
+  exports.Set(Napi::String::New(env, "sendBatch"), Napi::Function::New(env, SendBatch));
   exports.Set(Napi::String::New(env, "receive"), Napi::Function::New(env, Receive));
+  exports.Set(Napi::String::New(env, "invoke"), Napi::Function::New(env, Invoke));
   exports.Set(Napi::String::New(env, "execute"), Napi::Function::New(env, Execute));
+  exports.Set(Napi::String::New(env, "startReceiveEngine"), Napi::Function::New(env, StartReceiveEngine));
+  exports.Set(Napi::String::New(env, "stopReceiveEngine"), Napi::Function::New(env, StopReceiveEngine));
+  exports.Set(Napi::String::New(env, "startSendPacer"), Napi::Function::New(env, StartSendPacer));
+  exports.Set(Napi::String::New(env, "stopSendPacer"), Napi::Function::New(env, StopSendPacer));
+  exports.Set(Napi::String::New(env, "enqueueSends"), Napi::Function::New(env, EnqueueSends));
+  exports.Set(Napi::String::New(env, "cancelSends"), Napi::Function::New(env, CancelSends));
+  exports.Set(Napi::String::New(env, "getSendPacerStats"), Napi::Function::New(env, GetSendPacerStats));
+  exports.Set(Napi::String::New(env, "setUpdateFilter"), Napi::Function::New(env, SetUpdateFilter));
+  exports.Set(Napi::String::New(env, "getUpdateFilterStats"), Napi::Function::New(env, GetUpdateFilterStats));
+  exports.Set(Napi::String::New(env, "setSchedulerOptions"), Napi::Function::New(env, SetSchedulerOptions));
+  exports.Set(Napi::String::New(env, "setBinlogSyncDelay"), Napi::Function::New(env, SetBinlogSyncDelay));
+  exports.Set(Napi::String::New(env, "setDeferredMessageSearchIndexing"),
+              Napi::Function::New(env, SetDeferredMessageSearchIndexing));
+  exports.Set(Napi::String::New(env, "setUseIoUring"), Napi::Function::New(env, SetUseIoUring));
+  exports.Set(Napi::String::New(env, "setUseRingFileLog"), Napi::Function::New(env, SetUseRingFileLog));
+  exports.Set(Napi::String::New(env, "setClientLogVerbosityLevel"),
+              Napi::Function::New(env, SetClientLogVerbosityLevel));
+  exports.Set(Napi::String::New(env, "setHeapProfileSampleInterval"),
+              Napi::Function::New(env, SetHeapProfileSampleInterval));
+  exports.Set(Napi::String::New(env, "getHeapProfile"), Napi::Function::New(env, GetHeapProfile));
+  exports.Set(Napi::String::New(env, "setUseObjectArena"), Napi::Function::New(env, SetUseObjectArena));
+  exports.Set(Napi::String::New(env, "setTestDcServer"), Napi::Function::New(env, SetTestDcServer));
+  exports.Set(Napi::String::New(env, "getMetrics"), Napi::Function::New(env, GetMetrics));
   exports.Set(Napi::String::New(env, "getLibraryInfo"), Napi::Function::New(env, GetLibraryInfo));
   return exports;
 }
@@ -21,11 +21,10 @@ int main() {
 
   // Check for required symbols
   const char* symbols[] = {
-    "td_json_client_create",
-    "td_json_client_send",
-    "td_json_client_receive",
-    "td_json_client_execute",
-    "td_json_client_destroy"
+    "td_create_client_id",
+    "td_send",
+    "td_receive",
+    "td_execute"
   };
 
   int missing = 0;
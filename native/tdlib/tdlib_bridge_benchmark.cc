@@ -0,0 +1,375 @@
+// Offline load generator for the TDLib JSON bridge
+//
+// Creates N clients and drives M closed-loop request streams with requests
+// that TDLib answers without network access, through:
+//   addon - td_create_client_id/td_send with the addon's ClientTable and
+//           ReceiveEngine, requests tagged and tracked as by invoke()
+//   raw   - td_json_client_create/send/receive with one receive thread per client
+// and reports requests/s, p50/p99/p999 round-trip latency and RSS per client.
+//
+// Usage: tdlib_bridge_benchmark [addon|raw|all] [clients] [streams] [requests per stream] [payload bytes]
+// TDLIB_LIBRARY_PATH overrides the libtdjson location. RSS per client is the
+// growth of the process RSS, so compare it between separate runs of one mode.
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tdlib_client_table.h"
+#include "tdlib_metrics.h"
+#include "tdlib_receive_engine.h"
+#include "tdlib_send_pacer.h"
+#include "tdlib_update_filter.h"
+
+using td_json_client_create_t = void* (*)();
+using td_json_client_send_t = void (*)(void*, const char*);
+using td_json_client_receive_t = const char* (*)(void*, double);
+using td_json_client_destroy_t = void (*)(void*);
+
+struct TdJson {
+  td_create_client_id_t create_client_id{nullptr};
+  td_send_t send{nullptr};
+  TdReceiveApi receive;
+  td_execute_t execute{nullptr};
+  td_json_client_create_t json_client_create{nullptr};
+  td_json_client_send_t json_client_send{nullptr};
+  td_json_client_receive_t json_client_receive{nullptr};
+  td_json_client_destroy_t json_client_destroy{nullptr};
+};
+
+struct BenchmarkOptions {
+  std::string mode{"all"};
+  int clients{4};
+  int streams{16};
+  int requests{2000};
+  size_t payload_size{4096};
+};
+
+struct BenchmarkResult {
+  uint64_t completed{0};
+  uint64_t failed{0};
+  std::chrono::nanoseconds elapsed{0};
+  LatencyHistogram::Snapshot latency;
+  int64_t rss_per_client{0};
+};
+
+// Closed-loop request stream: one request in flight at a time
+struct Stream {
+  std::mutex mutex;
+  std::condition_variable completed_cv;
+  bool completed{false};
+  bool ok{false};
+
+  void complete(bool result) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      completed = true;
+      ok = result;
+    }
+    completed_cv.notify_one();
+  }
+
+  bool wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed_cv.wait(lock, [this] { return completed; });
+    completed = false;
+    return ok;
+  }
+};
+
+using SendFunction = std::function<void(int client_index, uint64_t request_id, const std::string& request)>;
+
+static const int kWarmupRequests = 50;
+static const std::chrono::seconds kRequestTimeout(30);
+static const char kSilenceLog[] = "{\"@type\":\"setLogVerbosityLevel\",\"new_verbosity_level\":0}";
+static const char kCloseRequest[] = "{\"@type\":\"close\"}";
+
+template <class T>
+static bool load_symbol(void* handle, const char* name, T& symbol) {
+  symbol = reinterpret_cast<T>(dlsym(handle, name));
+  if (symbol == nullptr) {
+    std::cerr << "ERROR: Symbol not found: " << name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static bool load_td_json(const char* path, TdJson& td) {
+  void* handle = dlopen(path, RTLD_NOW);
+  if (!handle) {
+    std::cerr << "ERROR: Failed to load library: " << dlerror() << std::endl;
+    return false;
+  }
+  // Optional, like in the addon
+  td.receive.receive_with_length =
+      reinterpret_cast<td_receive_with_length_t>(dlsym(handle, "td_receive_with_length"));
+  return load_symbol(handle, "td_create_client_id", td.create_client_id) &&
+         load_symbol(handle, "td_send", td.send) && load_symbol(handle, "td_receive", td.receive.receive) &&
+         load_symbol(handle, "td_execute", td.execute) &&
+         load_symbol(handle, "td_json_client_create", td.json_client_create) &&
+         load_symbol(handle, "td_json_client_send", td.json_client_send) &&
+         load_symbol(handle, "td_json_client_receive", td.json_client_receive) &&
+         load_symbol(handle, "td_json_client_destroy", td.json_client_destroy);
+}
+
+// Requests answered locally by TDLib in every authorization state
+static std::vector<std::string> make_requests(size_t payload_size) {
+  const std::string payload(payload_size, 'x');
+  const std::string element(std::max<size_t>(1, payload_size / 16), 'y');
+  std::string elements;
+  for (int i = 0; i < 16; ++i) {
+    elements += i == 0 ? "\"" : ",\"";
+    elements += element;
+    elements += '"';
+  }
+  return {
+      "{\"@type\":\"testCallString\",\"x\":\"" + payload + "\"}",
+      "{\"@type\":\"testSquareInt\",\"x\":12345}",
+      "{\"@type\":\"getOption\",\"name\":\"version\"}",
+      kSilenceLog,
+      "{\"@type\":\"testCallVectorString\",\"x\":[" + elements + "]}",
+  };
+}
+
+// Request identifiers carry the stream index in their upper half
+static uint64_t make_request_id(size_t stream_index, uint32_t sequence) {
+  return (static_cast<uint64_t>(stream_index + 1) << 32) | sequence;
+}
+
+static void complete_request(std::vector<Stream>& streams, uint64_t request_id, bool ok) {
+  uint64_t stream_index = (request_id >> 32) - 1;
+  if (stream_index < streams.size()) {
+    streams[stream_index].complete(ok);
+  }
+}
+
+static bool is_error(const char* data, size_t size) {
+  return get_response_type(data, size) == "error";
+}
+
+static int64_t get_rss_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0;
+  int64_t resident = 0;
+  statm >> size >> resident;
+  return resident * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Runs every stream to completion; returns the number of failed requests
+static uint64_t drive_streams(const BenchmarkOptions& options, const std::vector<std::string>& requests,
+                              std::vector<Stream>& streams, const SendFunction& send, int count,
+                              LatencyHistogram* latency) {
+  std::atomic<uint64_t> failed{0};
+  std::vector<std::thread> threads;
+  threads.reserve(streams.size());
+  for (size_t s = 0; s < streams.size(); ++s) {
+    threads.emplace_back([&, s] {
+      int client_index = static_cast<int>(s % static_cast<size_t>(options.clients));
+      for (int i = 0; i < count; ++i) {
+        const std::string& request = requests[(s + static_cast<size_t>(i)) % requests.size()];
+        auto start = std::chrono::steady_clock::now();
+        send(client_index, make_request_id(s, static_cast<uint32_t>(i)), request);
+        bool ok = streams[s].wait();
+        if (latency != nullptr) {
+          latency->record(std::chrono::steady_clock::now() - start);
+        }
+        if (!ok) {
+          failed.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return failed.load(std::memory_order_relaxed);
+}
+
+static BenchmarkResult measure(const BenchmarkOptions& options, const std::vector<std::string>& requests,
+                               std::vector<Stream>& streams, const SendFunction& send) {
+  drive_streams(options, requests, streams, send, kWarmupRequests, nullptr);
+
+  auto latency = std::make_unique<LatencyHistogram>();
+  BenchmarkResult result;
+  auto start = std::chrono::steady_clock::now();
+  result.failed = drive_streams(options, requests, streams, send, options.requests, latency.get());
+  result.elapsed = std::chrono::steady_clock::now() - start;
+  result.completed = static_cast<uint64_t>(options.streams) * static_cast<uint64_t>(options.requests);
+  result.latency = latency->snapshot();
+  return result;
+}
+
+static BenchmarkResult run_addon(const TdJson& td, const BenchmarkOptions& options,
+                                 const std::vector<std::string>& requests) {
+  int64_t rss_before = get_rss_bytes();
+  std::vector<Stream> streams(static_cast<size_t>(options.streams));
+  ClientTable clients;
+  UpdateFilterStats filter_stats;
+  SendPacer pacer;
+  ReceiveEngine engine(td.receive, clients, filter_stats, pacer, ReceiveEngineOptions(),
+                       [&streams](UpdateBatch&& batch) {
+                         for (const ReceivedUpdate& update : batch) {
+                           if (update.request_id != 0) {
+                             complete_request(streams, update.request_id,
+                                              !update.timed_out && !is_error(update.data.data(), update.data.size()));
+                           }
+                         }
+                       });
+  engine.start();
+
+  std::vector<ClientState*> states;
+  for (int i = 0; i < options.clients; ++i) {
+    states.push_back(clients.add(td.create_client_id()));
+  }
+
+  // Same steps as Invoke() in tdlib_addon.cc
+  auto send = [&](int client_index, uint64_t request_id, const std::string& request) {
+    ClientState* client = states[static_cast<size_t>(client_index)];
+    const std::string tagged = make_invoke_request(request.data(), request.size(), request_id);
+    engine.track_request(request_id, std::chrono::steady_clock::now() + kRequestTimeout);
+    client->counters.add_sent(1, tagged.size());
+    td.send(client->id, tagged.c_str());
+  };
+  BenchmarkResult result = measure(options, requests, streams, send);
+  result.rss_per_client = (get_rss_bytes() - rss_before) / options.clients;
+
+  for (ClientState* client : states) {
+    td.send(client->id, kCloseRequest);
+  }
+  auto close_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (clients.open_count() > 0 && std::chrono::steady_clock::now() < close_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  engine.stop();
+  return result;
+}
+
+static BenchmarkResult run_raw(const TdJson& td, const BenchmarkOptions& options,
+                               const std::vector<std::string>& requests) {
+  static const char kExtra[] = "\"@extra\":";
+
+  int64_t rss_before = get_rss_bytes();
+  std::vector<Stream> streams(static_cast<size_t>(options.streams));
+  std::vector<void*> handles;
+  for (int i = 0; i < options.clients; ++i) {
+    handles.push_back(td.json_client_create());
+  }
+
+  // td_json_client_receive must not be called concurrently for one client
+  std::atomic<bool> running{true};
+  std::vector<std::thread> receivers;
+  for (void* handle : handles) {
+    receivers.emplace_back([&, handle] {
+      while (running.load(std::memory_order_acquire)) {
+        const char* result = td.json_client_receive(handle, 0.1);
+        if (result == nullptr) {
+          continue;
+        }
+        const char* extra = std::strstr(result, kExtra);
+        if (extra != nullptr) {
+          uint64_t request_id = std::strtoull(extra + sizeof(kExtra) - 1, nullptr, 10);
+          complete_request(streams, request_id, !is_error(result, std::strlen(result)));
+        }
+      }
+    });
+  }
+
+  auto send = [&](int client_index, uint64_t request_id, const std::string& request) {
+    std::string tagged(request, 0, request.size() - 1);
+    tagged += ',';
+    tagged += kExtra;
+    tagged += std::to_string(request_id);
+    tagged += '}';
+    td.json_client_send(handles[static_cast<size_t>(client_index)], tagged.c_str());
+  };
+  BenchmarkResult result = measure(options, requests, streams, send);
+  result.rss_per_client = (get_rss_bytes() - rss_before) / options.clients;
+
+  running.store(false, std::memory_order_release);
+  for (auto& receiver : receivers) {
+    receiver.join();
+  }
+  for (void* handle : handles) {
+    td.json_client_destroy(handle);
+  }
+  return result;
+}
+
+static void print_result(const char* mode, const BenchmarkOptions& options, const BenchmarkResult& result) {
+  double seconds = std::chrono::duration<double>(result.elapsed).count();
+  auto micros = [&](double quantile) { return static_cast<double>(result.latency.value_at(quantile)) / 1000.0; };
+  std::printf("%-6s %7d %7d %9llu %12.0f %10.1f %10.1f %10.1f %7llu %12lld\n", mode, options.clients,
+              options.streams, static_cast<unsigned long long>(result.completed),
+              seconds > 0 ? static_cast<double>(result.completed) / seconds : 0.0, micros(0.5), micros(0.99),
+              micros(0.999), static_cast<unsigned long long>(result.failed),
+              static_cast<long long>(result.rss_per_client / 1024));
+}
+
+int main(int argc, char** argv) {
+  BenchmarkOptions options;
+  if (argc > 1) {
+    options.mode = argv[1];
+  }
+  if (argc > 2) {
+    options.clients = std::max(1, std::atoi(argv[2]));
+  }
+  if (argc > 3) {
+    options.streams = std::max(1, std::atoi(argv[3]));
+  }
+  if (argc > 4) {
+    options.requests = std::max(1, std::atoi(argv[4]));
+  }
+  if (argc > 5) {
+    options.payload_size = static_cast<size_t>(std::max(1, std::atoi(argv[5])));
+  }
+  bool run_addon_mode = options.mode == "addon" || options.mode == "all";
+  bool run_raw_mode = options.mode == "raw" || options.mode == "all";
+  if (!run_addon_mode && !run_raw_mode) {
+    std::cerr << "Usage: " << argv[0]
+              << " [addon|raw|all] [clients] [streams] [requests per stream] [payload bytes]" << std::endl;
+    return 2;
+  }
+
+  const char* lib_path = "vendor/tdlib/lib/libtdjson.so";
+  const char* env_path = std::getenv("TDLIB_LIBRARY_PATH");
+  if (env_path) {
+    lib_path = env_path;
+  }
+  TdJson td;
+  if (!load_td_json(lib_path, td)) {
+    return 1;
+  }
+  td.execute(kSilenceLog);
+
+  const std::vector<std::string> requests = make_requests(options.payload_size);
+  std::printf("%-6s %7s %7s %9s %12s %10s %10s %10s %7s %12s\n", "mode", "clients", "streams", "requests",
+              "requests/s", "p50 us", "p99 us", "p999 us", "failed", "RSS/client KiB");
+
+  uint64_t failed = 0;
+  if (run_addon_mode) {
+    BenchmarkResult result = run_addon(td, options, requests);
+    print_result("addon", options, result);
+    failed += result.failed;
+  }
+  if (run_raw_mode) {
+    BenchmarkResult result = run_raw(td, options, requests);
+    print_result("raw", options, result);
+    failed += result.failed;
+  }
+  return failed == 0 ? 0 : 1;
+}
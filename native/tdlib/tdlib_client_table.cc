@@ -0,0 +1,114 @@
+#include "tdlib_client_table.h"
+
+#include <cstring>
+
+ClientTable::~ClientTable() {
+  for (auto& chunk_ptr : chunks_) {
+    Chunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      continue;
+    }
+    for (auto& slot : chunk->slots) {
+      delete slot.load(std::memory_order_acquire);
+    }
+    delete chunk;
+  }
+}
+
+ClientState* ClientTable::add(int32_t client_id) {
+  if (client_id <= 0 || client_id > kMaxClientId) {
+    return nullptr;
+  }
+
+  auto lock = lock_timed(mutex_, AddonLock::ClientTable);
+  auto& chunk_ptr = chunks_[client_id >> kChunkBits];
+  Chunk* chunk = chunk_ptr.load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    chunk = new Chunk();
+    chunk_ptr.store(chunk, std::memory_order_release);
+  }
+
+  auto& slot = chunk->slots[client_id & (kChunkSize - 1)];
+  if (slot.load(std::memory_order_acquire) != nullptr) {
+    return nullptr;
+  }
+  auto* state = new ClientState(client_id);
+  slot.store(state, std::memory_order_release);
+  open_count_.fetch_add(1, std::memory_order_relaxed);
+  if (client_id > max_id_.load(std::memory_order_relaxed)) {
+    max_id_.store(client_id, std::memory_order_release);
+  }
+  return state;
+}
+
+bool ClientTable::mark_closed(int32_t client_id) {
+  ClientState* state = get(client_id);
+  if (state == nullptr) {
+    return false;
+  }
+  auto previous = state->status.exchange(ClientState::Status::Closed, std::memory_order_acq_rel);
+  if (previous == ClientState::Status::Closed) {
+    return false;
+  }
+  open_count_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void ClientTable::set_filter(ClientState& client, std::unique_ptr<UpdateFilter> filter) {
+  auto lock = lock_timed(mutex_, AddonLock::ClientTable);
+  const UpdateFilter* raw = nullptr;
+  if (filter != nullptr) {
+    for (const auto& interned : filters_) {
+      if (*interned == *filter) {
+        raw = interned.get();
+        break;
+      }
+    }
+    if (raw == nullptr) {
+      raw = filter.get();
+      filters_.push_back(std::move(filter));
+    }
+  }
+  client.filter.store(raw, std::memory_order_release);
+}
+
+int32_t get_response_client_id(const char* data, size_t size) {
+  static const char kKey[] = "\"@client_id\":";
+  static const size_t kKeySize = sizeof(kKey) - 1;
+
+  // ClientManager appends the identifier as the last field: ...,"@client_id":42}
+  size_t end = size;
+  while (end > 0 && data[end - 1] != '}') {
+    end--;
+  }
+  if (end == 0) {
+    return 0;
+  }
+  end--;
+
+  size_t begin = end;
+  while (begin > 0 && data[begin - 1] >= '0' && data[begin - 1] <= '9') {
+    begin--;
+  }
+  if (begin == end || end - begin > 10 || begin < kKeySize ||
+      std::memcmp(data + begin - kKeySize, kKey, kKeySize) != 0) {
+    return 0;
+  }
+
+  int64_t client_id = 0;
+  for (size_t i = begin; i < end; ++i) {
+    client_id = client_id * 10 + (data[i] - '0');
+  }
+  return client_id > INT32_MAX ? 0 : static_cast<int32_t>(client_id);
+}
+
+bool is_client_closed_update(const char* data, size_t size) {
+  static const char kPrefix[] = "{\"@type\":\"updateAuthorizationState\"";
+  static const size_t kPrefixSize = sizeof(kPrefix) - 1;
+  static const char kClosed[] = "\"authorizationStateClosed\"";
+
+  if (size < kPrefixSize || std::memcmp(data, kPrefix, kPrefixSize) != 0) {
+    return false;
+  }
+  return std::strstr(data + kPrefixSize, kClosed) != nullptr;
+}
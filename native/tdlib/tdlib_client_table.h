@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tdlib_metrics.h"
+#include "tdlib_update_filter.h"
+
+/**
+ * Native state of one TDLib client created with td_create_client_id.
+ *
+ * States are never freed while the addon is loaded: ClientManager never
+ * reuses client identifiers, so a closed slot simply stays closed and readers
+ * need no reference counting.
+ */
+struct ClientState {
+  enum class Status : uint8_t { Open, Closing, Closed };
+
+  explicit ClientState(int32_t id) : id(id) {}
+
+  const int32_t id;
+  std::atomic<Status> status{Status::Open};
+  // Owned by the ClientTable; nullptr delivers every update
+  std::atomic<const UpdateFilter*> filter{nullptr};
+  ClientCounters counters;
+};
+
+/**
+ * Lock-free lookup table from TDLib client identifier to ClientState.
+ *
+ * Identifiers are small positive integers handed out sequentially by
+ * ClientManager, so the table is a two-level array: lookups are two acquire
+ * loads, and only registration takes a mutex.
+ */
+class ClientTable {
+ public:
+  static constexpr int32_t kChunkBits = 10;
+  static constexpr int32_t kChunkSize = 1 << kChunkBits;
+  static constexpr int32_t kMaxChunks = 1024;
+  static constexpr int32_t kMaxClientId = kChunkSize * kMaxChunks - 1;
+
+  ClientTable() = default;
+  ~ClientTable();
+
+  ClientTable(const ClientTable&) = delete;
+  ClientTable& operator=(const ClientTable&) = delete;
+
+  // Returns nullptr for unknown identifiers
+  ClientState* get(int32_t client_id) const {
+    if (client_id <= 0 || client_id > kMaxClientId) {
+      return nullptr;
+    }
+    Chunk* chunk = chunks_[client_id >> kChunkBits].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      return nullptr;
+    }
+    return chunk->slots[client_id & (kChunkSize - 1)].load(std::memory_order_acquire);
+  }
+
+  // Returns nullptr if the identifier is out of range or already registered
+  ClientState* add(int32_t client_id);
+
+  // Moves an open or closing client to Closed; returns false if it was not open
+  bool mark_closed(int32_t client_id);
+
+  // Replaces the update filter of a client; nullptr removes it. Filters are
+  // interned: a filter equal to one set before shares its instance, so the
+  // table keeps one instance per distinct filter. Instances stay alive until
+  // the table is destroyed because the receive thread may still be reading
+  // them.
+  void set_filter(ClientState& client, std::unique_ptr<UpdateFilter> filter);
+
+  size_t open_count() const { return open_count_.load(std::memory_order_relaxed); }
+
+  // Calls f(ClientState&) for every registered client
+  template <class F>
+  void for_each(F&& f) const {
+    int32_t max_id = max_id_.load(std::memory_order_acquire);
+    for (int32_t id = 1; id <= max_id; ++id) {
+      ClientState* state = get(id);
+      if (state != nullptr) {
+        f(*state);
+      }
+    }
+  }
+
+ private:
+  struct Chunk {
+    std::array<std::atomic<ClientState*>, kChunkSize> slots{};
+  };
+
+  std::array<std::atomic<Chunk*>, kMaxChunks> chunks_{};
+  std::atomic<size_t> open_count_{0};
+  std::atomic<int32_t> max_id_{0};
+  // Distinct filters ever set
+  std::vector<std::unique_ptr<UpdateFilter>> filters_;
+  std::mutex mutex_;
+};
+
+// Extracts the trailing "@client_id" of a td_receive response; returns 0 if absent
+int32_t get_response_client_id(const char* data, size_t size);
+
+// Checks whether a response is updateAuthorizationState with authorizationStateClosed
+bool is_client_closed_update(const char* data, size_t size);
@@ -0,0 +1,343 @@
+// Table tests of the JSON scanning done on raw td_receive responses by the
+// receive engine, the update filter and the send pacer. Needs no libtdjson.
+
+#include "tdlib_client_table.h"
+#include "tdlib_receive_engine.h"
+#include "tdlib_send_pacer.h"
+#include "tdlib_update_filter.h"
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+template <class T>
+static void check_equal(const std::string& name, const T& actual, const T& expected) {
+  if (!(actual == expected)) {
+    std::cerr << "FAIL: " << name << ": got [" << actual << "], expected [" << expected << "]" << std::endl;
+    failures++;
+  }
+}
+
+static void test_response_type() {
+  struct Case {
+    const char* json;
+    const char* type;
+  };
+  const Case cases[] = {
+      {R"({"@type":"updateUserStatus","user_id":1})", "updateUserStatus"},
+      {R"({"@type":"error","code":400})", "error"},
+      // @type is always the first field; anything else is not a TDLib response
+      {R"({"user_id":1,"@type":"updateUserStatus"})", ""},
+      {R"( {"@type":"ok"})", ""},
+      // Truncated input
+      {R"({"@type":"updateUser)", ""},
+      {R"({"@type":")", ""},
+      {R"({"@ty)", ""},
+      {"", ""},
+  };
+  for (const auto& test : cases) {
+    check_equal(std::string("get_response_type ") + test.json,
+                std::string(get_response_type(test.json, std::strlen(test.json))), std::string(test.type));
+  }
+}
+
+static void test_coalesce_key() {
+  struct Case {
+    const char* json;
+    const char* key;
+  };
+  const Case cases[] = {
+      {R"({"@type":"updateUserStatus","user_id":42,"status":{"@type":"userStatusOnline","expires":1}})",
+       R"({"@type":"updateUserStatus","user_id":42)"},
+      {R"({"@type":"updateChatReadInbox","chat_id":-1001,"last_read_inbox_message_id":5})",
+       R"({"@type":"updateChatReadInbox","chat_id":-1001)"},
+      {R"({"@type":"updateOption","name":"version","value":{"@type":"optionValueString"}})",
+       R"({"@type":"updateOption","name":"version")"},
+      // Escaped quotes and backslashes don't end a string key
+      {R"({"@type":"updateOption","name":"a\"b,c","value":1})", R"({"@type":"updateOption","name":"a\"b,c")"},
+      {R"({"@type":"updateOption","name":"a\\","value":1})", R"({"@type":"updateOption","name":"a\\")"},
+      // A nested first field identifies nothing, so all updates of the type share a key
+      {R"({"@type":"updateConnectionState","state":{"@type":"connectionStateReady"}})",
+       R"({"@type":"updateConnectionState")"},
+      {R"({"@type":"updateActiveNotifications","groups":[{"id":1}]})", R"({"@type":"updateActiveNotifications")"},
+      {R"({"@type":"updateSelectedBackground"})", R"({"@type":"updateSelectedBackground")"},
+      {R"({"@type":"updateUserStatus","user_id":42})", R"({"@type":"updateUserStatus","user_id":42)"},
+      // Truncated input never reads past the end
+      {R"({"@type":"updateUserStatus","user_id":42)", R"({"@type":"updateUserStatus","user_id":42)"},
+      {R"({"@type":"updateUserStatus","user_id":)", R"({"@type":"updateUserStatus")"},
+      {R"({"@type":"updateUserStatus","user_i)", R"({"@type":"updateUserStatus")"},
+      {R"({"@type":"updateOption","name":"vers)", R"({"@type":"updateOption","name":"vers)"},
+      {R"({"@type":"updateOption","name":"a\)", R"({"@type":"updateOption","name":"a\)"},
+      {R"({"@type":"updateUserStatus")", R"({"@type":"updateUserStatus")"},
+      {R"({"@type":"updateUser)", ""},
+      {"", ""},
+  };
+  for (const auto& test : cases) {
+    check_equal(std::string("get_coalesce_key ") + test.json,
+                std::string(get_coalesce_key(test.json, std::strlen(test.json))), std::string(test.key));
+  }
+}
+
+static void test_response_client_id() {
+  struct Case {
+    const char* json;
+    int32_t client_id;
+  };
+  const Case cases[] = {
+      {R"({"@type":"ok","@client_id":3})", 3},
+      {R"({"@type":"ok","@extra":"invoke:7","@client_id":2147483647})", 2147483647},
+      {"{\"@type\":\"ok\",\"@client_id\":12}\n", 12},
+      // Missing or malformed @client_id
+      {R"({"@type":"ok"})", 0},
+      {R"({"@type":"ok","client_id":3})", 0},
+      {R"({"@type":"ok","@client_id":"3"})", 0},
+      {R"({"@type":"ok","@client_id":2147483648})", 0},
+      {R"({"@type":"ok","@client_id":12345678901})", 0},
+      // Truncated input
+      {R"({"@type":"ok","@client_id":3)", 0},
+      {R"({"@type":"ok","@client_id":)", 0},
+      {"}", 0},
+      {"", 0},
+  };
+  for (const auto& test : cases) {
+    check_equal(std::string("get_response_client_id ") + test.json,
+                get_response_client_id(test.json, std::strlen(test.json)), test.client_id);
+  }
+}
+
+static void test_request_ids() {
+  struct Case {
+    const char* json;
+    uint64_t request_id;
+    uint64_t send_id;
+  };
+  const Case cases[] = {
+      {R"({"@type":"ok","@extra":"invoke:7","@client_id":1})", 7, 0},
+      {R"({"@type":"message","id":1,"@extra":"pace:9999999999999999999","@client_id":1})", 0,
+       9999999999999999999ull},
+      {R"({"@type":"message","id":1,"@extra":"pace:99999999999999999999","@client_id":1})", 0, 0},
+      // "@extra" is recognized only in front of the trailing @client_id
+      {R"({"@type":"ok","@extra":"invoke:7"})", 0, 0},
+      {R"({"@type":"ok","@extra":"invoke:7","@client_id":1)", 0, 0},
+      {R"({"@type":"ok","text":"\"@extra\":\"invoke:7\"","@client_id":1})", 0, 0},
+      {R"({"@type":"ok","@extra":"invoke:","@client_id":1})", 0, 0},
+      {R"({"@type":"ok","@extra":"other:7","@client_id":1})", 0, 0},
+      {R"({"@type":"ok","@client_id":1})", 0, 0},
+  };
+  for (const auto& test : cases) {
+    size_t size = std::strlen(test.json);
+    check_equal(std::string("get_invoke_request_id ") + test.json, get_invoke_request_id(test.json, size),
+                test.request_id);
+    check_equal(std::string("get_paced_send_id ") + test.json, get_paced_send_id(test.json, size), test.send_id);
+  }
+
+  // ClientManager appends @client_id to the request's "@extra" in the response
+  std::string response = make_invoke_request(R"({"@type":"getMe"})", 17, 42);
+  response.pop_back();
+  response += R"(,"@client_id":1})";
+  check_equal(std::string("make_invoke_request ") + response, get_invoke_request_id(response.data(), response.size()),
+              static_cast<uint64_t>(42));
+}
+
+static void test_has_extra() {
+  struct Case {
+    const char* json;
+    bool has_extra;
+  };
+  const Case cases[] = {
+      {R"({"@type":"getMe","@extra":"x"})", true},
+      {R"({ "@extra" : 1, "@type":"getMe"})", true},
+      {R"({"@type":"getMe"})", false},
+      // Only top-level fields count
+      {R"({"@type":"sendMessage","reply_to":{"@extra":"x"}})", false},
+      {R"({"@type":"getChats","list":[{"@extra":"x"}]})", false},
+      // Values and escaped strings are not keys
+      {R"({"@type":"searchChats","query":"@extra"})", false},
+      {R"({"@type":"searchChats","query":"\",\"@extra\":\""})", false},
+      {R"({"@type":"getMe","@extra_data":"x"})", false},
+  };
+  for (const auto& test : cases) {
+    check_equal(std::string("has_extra ") + test.json, has_extra(test.json, std::strlen(test.json)), test.has_extra);
+  }
+}
+
+static void test_parse_error() {
+  struct Case {
+    const char* json;
+    int32_t code;
+    const char* message;
+  };
+  const Case cases[] = {
+      {R"({"@type":"error","code":429,"message":"Too Many Requests: retry after 7"})", 429,
+       "Too Many Requests: retry after 7"},
+      {R"({"@type":"error","code":-1,"message":"Request aborted"})", -1, "Request aborted"},
+      // Escaped characters are unescaped
+      {R"({"@type":"error","code":400,"message":"a\"b\\c"})", 400, "a\"b\\c"},
+      {R"({"@type":"error","code":400})", 400, ""},
+      // Not an error
+      {R"({"@type":"ok"})", 0, "Unknown error"},
+      {R"({"code":400,"@type":"error","message":"X"})", 0, "Unknown error"},
+      {R"({"@type":"error","code":"400","message":"X"})", 0, "Unknown error"},
+      // Truncated input
+      {R"({"@type":"error","code":400,"message":"CHAT_WR)", 400, "CHAT_WR"},
+      {R"({"@type":"error","code":400,"message":"a\)", 400, "a\\"},
+      {R"({"@type":"error","code":)", 0, "Unknown error"},
+      {"", 0, "Unknown error"},
+  };
+  for (const auto& test : cases) {
+    int32_t code = 0;
+    std::string message;
+    parse_error(test.json, code, message);
+    check_equal(std::string("parse_error code ") + test.json, code, test.code);
+    check_equal(std::string("parse_error message ") + test.json, message, std::string(test.message));
+  }
+}
+
+static void test_flood_wait_seconds() {
+  struct Case {
+    int32_t code;
+    const char* message;
+    int32_t seconds;
+  };
+  const Case cases[] = {
+      {429, "Too Many Requests: retry after 15", 15},
+      {420, "FLOOD_WAIT_30", 30},
+      {400, "SLOWMODE_WAIT_5", 5},
+      {420, "FLOOD_PREMIUM_WAIT_3", 3},
+      // Waits are at least a second and at most two weeks
+      {420, "FLOOD_WAIT_0", 1},
+      {420, "FLOOD_WAIT_99999999999", 14 * 24 * 60 * 60},
+      // TDLib uses the "retry after" form only with the code 429
+      {400, "Too Many Requests: retry after 15", 0},
+      {429, "Too Many Requests: retry after ", 0},
+      {420, "FLOOD_WAIT_", 0},
+      {420, "FLOOD_WAIT_X", 0},
+      {400, "CHAT_WRITE_FORBIDDEN", 0},
+      {429, "", 0},
+  };
+  for (const auto& test : cases) {
+    check_equal(std::string("get_flood_wait_seconds ") + std::to_string(test.code) + " " + test.message,
+                get_flood_wait_seconds(test.code, test.message), test.seconds);
+  }
+}
+
+static void test_filter_interning() {
+  ClientTable clients;
+  auto make_filter = [](std::vector<std::string> types) {
+    return std::make_unique<UpdateFilter>(UpdateFilter::Mode::Deny, std::move(types), std::vector<std::string>());
+  };
+  ClientState& first = *clients.add(1);
+  ClientState& second = *clients.add(2);
+  clients.set_filter(first, make_filter({"updateUserStatus", "updateOption"}));
+  clients.set_filter(second, make_filter({"updateOption", "updateUserStatus", "updateOption"}));
+  check_equal(std::string("equal filters share an instance"), first.filter.load() == second.filter.load(), true);
+
+  clients.set_filter(second, make_filter({"updateOption"}));
+  check_equal(std::string("different filters do not"), first.filter.load() == second.filter.load(), false);
+  const UpdateFilter* replaced = second.filter.load();
+  clients.set_filter(second, nullptr);
+  clients.set_filter(second, make_filter({"updateOption"}));
+  check_equal(std::string("a filter set again is reused"), second.filter.load() == replaced, true);
+}
+
+// Responses returned by fake_receive, in order
+static std::mutex responses_mutex;
+static std::deque<std::string> responses;
+static std::string current_response;
+
+static const char* fake_receive(double timeout) {
+  {
+    std::lock_guard<std::mutex> lock(responses_mutex);
+    if (!responses.empty()) {
+      current_response = std::move(responses.front());
+      responses.pop_front();
+      return current_response.c_str();
+    }
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(std::min(timeout, 0.01)));
+  return nullptr;
+}
+
+static void test_coalescing_order() {
+  ClientTable clients;
+  UpdateFilterStats filter_stats;
+  SendPacer pacer;
+  for (int32_t client_id : {1, 2}) {
+    clients.set_filter(*clients.add(client_id),
+                       std::make_unique<UpdateFilter>(UpdateFilter::Mode::Deny, std::vector<std::string>(),
+                                                      std::vector<std::string>{"updateUserStatus"}));
+  }
+
+  const std::string first = R"({"@type":"updateUserStatus","user_id":5,"status":"online","@client_id":1})";
+  const std::string other = R"({"@type":"updateNewMessage","message":{"id":1},"@client_id":1})";
+  const std::string other_client = R"({"@type":"updateUserStatus","user_id":5,"status":"online","@client_id":2})";
+  const std::string other_user = R"({"@type":"updateUserStatus","user_id":6,"status":"online","@client_id":1})";
+  const std::string newest = R"({"@type":"updateUserStatus","user_id":5,"status":"offline","@client_id":1})";
+  {
+    std::lock_guard<std::mutex> lock(responses_mutex);
+    responses.assign({first, other, other_client, newest, other_user});
+  }
+
+  std::mutex batches_mutex;
+  std::vector<UpdateBatch> batches;
+  ReceiveEngineOptions options;
+  // The batch is complete once the last response is added; the coalesced one takes no slot
+  options.max_batch_size = 4;
+  options.flush_interval = std::chrono::milliseconds(10000);
+  TdReceiveApi receive;
+  receive.receive = fake_receive;
+  ReceiveEngine engine(receive, clients, filter_stats, pacer, options, [&](UpdateBatch&& batch) {
+    std::lock_guard<std::mutex> lock(batches_mutex);
+    batches.push_back(std::move(batch));
+  });
+  engine.start();
+  for (int i = 0; i < 500; i++) {
+    std::lock_guard<std::mutex> lock(batches_mutex);
+    if (!batches.empty()) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  engine.stop();
+
+  check_equal(std::string("coalesced batch count"), batches.size(), static_cast<size_t>(1));
+  if (batches.empty()) {
+    return;
+  }
+  // The newest status replaces the first one in its slot, ahead of the updates received in between
+  const std::vector<std::string> expected = {newest, other, other_client, other_user};
+  const UpdateBatch& batch = batches[0];
+  check_equal(std::string("coalesced batch size"), batch.size(), expected.size());
+  for (size_t i = 0; i < std::min(batch.size(), expected.size()); i++) {
+    check_equal("coalesced batch update " + std::to_string(i), batch[i].data, expected[i]);
+  }
+  check_equal(std::string("coalesced count"), filter_stats.snapshot()["updateUserStatus"].coalesced,
+              static_cast<uint64_t>(1));
+}
+
+int main() {
+  test_response_type();
+  test_coalesce_key();
+  test_response_client_id();
+  test_request_ids();
+  test_has_extra();
+  test_parse_error();
+  test_flood_wait_seconds();
+  test_filter_interning();
+  test_coalescing_order();
+
+  if (failures > 0) {
+    std::cerr << "FAILED: " << failures << " checks failed" << std::endl;
+    return 1;
+  }
+  std::cout << "SUCCESS: All checks passed" << std::endl;
+  return 0;
+}
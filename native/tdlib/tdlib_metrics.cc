@@ -0,0 +1,111 @@
+#include "tdlib_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+size_t LatencyHistogram::bucket_index(uint64_t value_ns) {
+  if (value_ns < kSubBucketCount) {
+    return static_cast<size_t>(value_ns);
+  }
+  int exponent = 63 - __builtin_clzll(value_ns);
+  if (exponent > kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  uint64_t sub_bucket = (value_ns >> (exponent - kSubBucketBits)) - kSubBucketCount;
+  return static_cast<size_t>(kSubBucketCount + (exponent - kSubBucketBits) * kSubBucketCount + sub_bucket);
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  int exponent = static_cast<int>((index - kSubBucketCount) / kSubBucketCount) + kSubBucketBits;
+  uint64_t sub_bucket = (index - kSubBucketCount) % kSubBucketCount;
+  int shift = exponent - kSubBucketBits;
+  return ((kSubBucketCount + sub_bucket) << shift) + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds value) {
+  uint64_t value_ns = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+  buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  if (value_ns == 0) {
+    return;
+  }
+  sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+  uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (value_ns > max_ns && !max_ns_.compare_exchange_weak(max_ns, value_ns, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot snapshot;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[i];
+  }
+  snapshot.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+  snapshot.max_ns = max_ns_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::value_at(double quantile) const {
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t target = static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count)));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= target) {
+      return std::min(bucket_upper_bound(i), max_ns);
+    }
+  }
+  return max_ns;
+}
+
+void ClientCounters::add_received(const char* data, size_t size) {
+  static const char kUpdatePrefix[] = "{\"@type\":\"update";
+  static const size_t kUpdatePrefixSize = sizeof(kUpdatePrefix) - 1;
+
+  bool is_update = size > kUpdatePrefixSize && std::memcmp(data, kUpdatePrefix, kUpdatePrefixSize) == 0;
+  (is_update ? updates_received : responses_received).fetch_add(1, std::memory_order_relaxed);
+  bytes_received.fetch_add(size, std::memory_order_relaxed);
+}
+
+const char* get_lock_name(AddonLock lock) {
+  switch (lock) {
+    case AddonLock::Engine:
+      return "engine";
+    case AddonLock::RequestQueue:
+      return "requestQueue";
+    case AddonLock::FilterStats:
+      return "filterStats";
+    case AddonLock::ClientTable:
+      return "clientTable";
+    case AddonLock::SendPacer:
+      return "sendPacer";
+    default:
+      return "unknown";
+  }
+}
+
+AddonMetrics& addon_metrics() {
+  static AddonMetrics metrics;
+  return metrics;
+}
+
+std::unique_lock<std::mutex> lock_timed(std::mutex& mutex, AddonLock lock) {
+  LatencyHistogram& histogram = addon_metrics().lock_wait[static_cast<size_t>(lock)];
+  std::unique_lock<std::mutex> guard(mutex, std::try_to_lock);
+  if (guard.owns_lock()) {
+    histogram.record(std::chrono::nanoseconds(0));
+    return guard;
+  }
+  auto start = std::chrono::steady_clock::now();
+  guard.lock();
+  histogram.record(std::chrono::steady_clock::now() - start);
+  return guard;
+}
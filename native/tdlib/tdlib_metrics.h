@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 8ns are counted exactly; above that every power of two is split
+ * into 8 sub-buckets, bounding the relative error of reported percentiles by
+ * 12.5%. Values beyond 2^40ns (about 18 minutes) land in the last bucket.
+ * Recording is a handful of relaxed atomic operations and is safe from any
+ * thread; snapshots are not atomic across buckets, which is fine for scraping.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  static constexpr int kMaxExponent = 40;
+  static constexpr size_t kBucketCount = kSubBucketCount + (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+  struct Snapshot {
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+    uint64_t max_ns{0};
+    std::array<uint64_t, kBucketCount> buckets{};
+
+    // Upper bound of the bucket holding the given quantile, capped by max_ns
+    uint64_t value_at(double quantile) const;
+  };
+
+  void record(std::chrono::nanoseconds value);
+  Snapshot snapshot() const;
+
+  static size_t bucket_index(uint64_t value_ns);
+  static uint64_t bucket_upper_bound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+/**
+ * Traffic counters of one client. Incremented with relaxed atomics on the
+ * thread that sends or receives; read by getMetrics().
+ */
+struct ClientCounters {
+  std::atomic<uint64_t> requests_sent{0};
+  std::atomic<uint64_t> responses_received{0};
+  std::atomic<uint64_t> updates_received{0};
+  std::atomic<uint64_t> bytes_sent{0};
+  std::atomic<uint64_t> bytes_received{0};
+
+  void add_sent(uint64_t requests, uint64_t bytes) {
+    requests_sent.fetch_add(requests, std::memory_order_relaxed);
+    bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  // Responses to requests are told apart from updates by their @type
+  void add_received(const char* data, size_t size);
+};
+
+// Mutexes whose acquisition time is measured
+enum class AddonLock : uint8_t { Engine, RequestQueue, FilterStats, ClientTable, SendPacer, Count };
+
+const char* get_lock_name(AddonLock lock);
+
+/**
+ * Process-wide instrumentation of the addon's hot paths
+ */
+struct AddonMetrics {
+  // invoke() send until the response reaches the receive thread
+  LatencyHistogram response_latency;
+  std::array<LatencyHistogram, static_cast<size_t>(AddonLock::Count)> lock_wait;
+
+  // Batches handed to the JS thread and not delivered yet
+  std::atomic<uint64_t> queued_batches{0};
+  std::atomic<uint64_t> queued_updates{0};
+};
+
+AddonMetrics& addon_metrics();
+
+// Locks the mutex, recording the time spent waiting for it. An uncontended
+// lock costs no clock reads.
+std::unique_lock<std::mutex> lock_timed(std::mutex& mutex, AddonLock lock);
@@ -0,0 +1,325 @@
+#include "tdlib_receive_engine.h"
+
+#include "tdlib_send_pacer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+const char* TdReceiveApi::operator()(double timeout, size_t& size) const {
+  if (receive_with_length != nullptr) {
+    return receive_with_length(timeout, &size);
+  }
+  const char* result = receive(timeout);
+  size = result != nullptr ? std::strlen(result) : 0;
+  return result;
+}
+
+ReceiveEngine::ReceiveEngine(TdReceiveApi receive, ClientTable& clients, UpdateFilterStats& filter_stats,
+                             SendPacer& pacer, ReceiveEngineOptions options, BatchSink sink)
+    : receive_(receive),
+      clients_(clients),
+      filter_stats_(filter_stats),
+      pacer_(pacer),
+      options_(options),
+      sink_(std::move(sink)) {
+  options_.max_batch_size = std::max<size_t>(1, options_.max_batch_size);
+  options_.flush_interval = std::max(options_.flush_interval, std::chrono::milliseconds(1));
+  options_.idle_timeout = std::max(options_.idle_timeout, std::chrono::milliseconds(1));
+}
+
+ReceiveEngine::~ReceiveEngine() {
+  stop();
+}
+
+void ReceiveEngine::start() {
+  bool expected = false;
+  if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void ReceiveEngine::stop() {
+  bool expected = true;
+  if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
+    return;
+  }
+  // td_receive returns at the latest after one idle timeout
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ReceiveEngine::add_update(UpdateBatch& batch, int32_t client_id, ClientState* client, const char* data,
+                               size_t size) {
+  const UpdateFilter* filter = client != nullptr ? client->filter.load(std::memory_order_acquire) : nullptr;
+  if (filter == nullptr) {
+    batch.push_back(ReceivedUpdate{client_id, std::string(data, size)});
+    return;
+  }
+
+  std::string_view type = get_response_type(data, size);
+  if (!filter->accepts(type)) {
+    filter_stats_.add_dropped(type);
+    return;
+  }
+
+  if (filter->coalesces(type)) {
+    std::string_view key = get_coalesce_key(data, size);
+    std::string batch_key = std::to_string(client_id);
+    batch_key.append(key.data(), key.size());
+    auto it = coalesced_.find(batch_key);
+    if (it != coalesced_.end()) {
+      // The newest value takes the slot of the first update with this key, so it is delivered ahead of the updates
+      // received in between; a coalesced type must not be ordered against other updates
+      batch[it->second].data.assign(data, size);
+      filter_stats_.add_coalesced(type);
+      return;
+    }
+    coalesced_.emplace(std::move(batch_key), batch.size());
+  }
+
+  batch.push_back(ReceivedUpdate{client_id, std::string(data, size)});
+}
+
+void ReceiveEngine::track_request(uint64_t request_id, std::chrono::steady_clock::time_point deadline) {
+  auto sent_at = std::chrono::steady_clock::now();
+  auto lock = lock_timed(new_requests_mutex_, AddonLock::RequestQueue);
+  new_requests_.push_back(NewRequest{request_id, sent_at, deadline});
+}
+
+void ReceiveEngine::take_new_requests() {
+  std::vector<NewRequest> new_requests;
+  {
+    auto lock = lock_timed(new_requests_mutex_, AddonLock::RequestQueue);
+    if (new_requests_.empty()) {
+      return;
+    }
+    new_requests.swap(new_requests_);
+  }
+  for (const auto& request : new_requests) {
+    requests_.emplace(request.request_id,
+                      TrackedRequest{deadlines_.emplace(request.deadline, request.request_id), request.sent_at});
+  }
+}
+
+bool ReceiveEngine::complete_request(uint64_t request_id) {
+  auto it = requests_.find(request_id);
+  if (it == requests_.end()) {
+    // Already expired
+    return false;
+  }
+  addon_metrics().response_latency.record(std::chrono::steady_clock::now() - it->second.sent_at);
+  deadlines_.erase(it->second.deadline);
+  requests_.erase(it);
+  return true;
+}
+
+void ReceiveEngine::expire_requests(UpdateBatch& batch, std::chrono::steady_clock::time_point now) {
+  while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+    uint64_t request_id = deadlines_.begin()->second;
+    requests_.erase(request_id);
+    deadlines_.erase(deadlines_.begin());
+
+    ReceivedUpdate timeout{0, std::string()};
+    timeout.request_id = request_id;
+    timeout.timed_out = true;
+    batch.push_back(std::move(timeout));
+  }
+}
+
+void ReceiveEngine::flush(UpdateBatch& batch) {
+  coalesced_.clear();
+  if (batch.empty()) {
+    return;
+  }
+  sink_(std::move(batch));
+  batch = UpdateBatch();
+  batch.reserve(options_.max_batch_size);
+}
+
+void ReceiveEngine::run() {
+  using clock = std::chrono::steady_clock;
+
+  UpdateBatch batch;
+  batch.reserve(options_.max_batch_size);
+  clock::time_point batch_deadline;
+
+  while (running_.load(std::memory_order_acquire)) {
+    clock::time_point wake_up = batch.empty() ? clock::now() + options_.idle_timeout : batch_deadline;
+    if (!deadlines_.empty()) {
+      wake_up = std::min(wake_up, deadlines_.begin()->first);
+    }
+    double timeout = std::max(0.0, std::chrono::duration<double>(wake_up - clock::now()).count());
+
+    size_t size = 0;
+    const char* result = receive_(timeout, size);
+    // Requests are registered before they are sent, so a response always
+    // finds its request here
+    take_new_requests();
+
+    bool was_empty = batch.empty();
+    if (result != nullptr) {
+      int32_t client_id = get_response_client_id(result, size);
+      ClientState* client = clients_.get(client_id);
+      if (client != nullptr) {
+        client->counters.add_received(result, size);
+        if (is_client_closed_update(result, size)) {
+          clients_.mark_closed(client_id);
+        }
+      }
+
+      uint64_t request_id = get_invoke_request_id(result, size);
+      uint64_t send_id = request_id == 0 ? get_paced_send_id(result, size) : 0;
+      if (request_id != 0) {
+        if (complete_request(request_id)) {
+          ReceivedUpdate response{client_id, std::string(result, size)};
+          response.request_id = request_id;
+          batch.push_back(std::move(response));
+        }
+      } else if (send_id != 0) {
+        // Reported to JS by the pacer together with the outcome of the send
+        pacer_.on_response(client_id, send_id, result, size);
+      } else {
+        pacer_.on_update(client_id, result, size);
+        add_update(batch, client_id, client, result, size);
+      }
+    }
+    expire_requests(batch, clock::now());
+    if (was_empty && !batch.empty()) {
+      batch_deadline = clock::now() + options_.flush_interval;
+    }
+
+    if (!batch.empty() && (batch.size() >= options_.max_batch_size || clock::now() >= batch_deadline)) {
+      flush(batch);
+    }
+  }
+
+  flush(batch);
+}
+
+static const char kInvokeExtra[] = "\"@extra\":\"invoke:";
+static const char kPacedSendExtra[] = "\"@extra\":\"pace:";
+
+template <size_t N>
+static std::string append_extra(const char* request, size_t size, const char (&extra)[N], uint64_t id) {
+  size_t end = size;
+  while (end > 0 && request[end - 1] != '}') {
+    end--;
+  }
+  std::string result;
+  if (end == 0) {
+    // Not an object; TDLib reports the parse error
+    result.assign(request, size);
+    return result;
+  }
+  end--;
+
+  size_t last = end;
+  while (last > 0 && std::isspace(static_cast<unsigned char>(request[last - 1]))) {
+    last--;
+  }
+  bool is_empty = last > 0 && request[last - 1] == '{';
+
+  result.reserve(end + N + 24);
+  result.append(request, end);
+  if (!is_empty) {
+    result += ',';
+  }
+  result += extra;
+  result += std::to_string(id);
+  result += "\"}";
+  return result;
+}
+
+template <size_t N>
+static uint64_t get_extra_id(const char* data, size_t size, const char (&extra)[N]) {
+  static const char kClientId[] = ",\"@client_id\":";
+  static const size_t kClientIdSize = sizeof(kClientId) - 1;
+  const size_t extra_size = N - 1;
+
+  // ClientManager appends ,"@extra":...,"@client_id":N} to every response
+  size_t end = size;
+  while (end > 0 && data[end - 1] != '}') {
+    end--;
+  }
+  if (end == 0) {
+    return 0;
+  }
+  end--;
+  while (end > 0 && data[end - 1] >= '0' && data[end - 1] <= '9') {
+    end--;
+  }
+  if (end < kClientIdSize || std::memcmp(data + end - kClientIdSize, kClientId, kClientIdSize) != 0) {
+    return 0;
+  }
+  end -= kClientIdSize;
+
+  if (end == 0 || data[end - 1] != '"') {
+    return 0;
+  }
+  end--;
+  size_t begin = end;
+  while (begin > 0 && data[begin - 1] >= '0' && data[begin - 1] <= '9') {
+    begin--;
+  }
+  if (begin == end || end - begin > 19 || begin < extra_size ||
+      std::memcmp(data + begin - extra_size, extra, extra_size) != 0) {
+    return 0;
+  }
+
+  uint64_t id = 0;
+  for (size_t i = begin; i < end; ++i) {
+    id = id * 10 + static_cast<uint64_t>(data[i] - '0');
+  }
+  return id;
+}
+
+bool has_extra(const char* request, size_t size) {
+  static const char kExtraKey[] = "\"@extra\"";
+  static const size_t kExtraKeySize = sizeof(kExtraKey) - 1;
+
+  int depth = 0;
+  bool expect_key = false;
+  for (size_t i = 0; i < size; ++i) {
+    char c = request[i];
+    if (c == '"') {
+      if (depth == 1 && expect_key && size - i >= kExtraKeySize &&
+          std::memcmp(request + i, kExtraKey, kExtraKeySize) == 0) {
+        return true;
+      }
+      expect_key = false;
+      for (++i; i < size && request[i] != '"'; ++i) {
+        if (request[i] == '\\') {
+          ++i;
+        }
+      }
+    } else if (c == '{' || c == '[') {
+      depth++;
+      expect_key = c == '{' && depth == 1;
+    } else if (c == '}' || c == ']') {
+      depth--;
+    } else if (c == ',') {
+      expect_key = depth == 1;
+    }
+  }
+  return false;
+}
+
+std::string make_invoke_request(const char* request, size_t size, uint64_t request_id) {
+  return append_extra(request, size, kInvokeExtra, request_id);
+}
+
+uint64_t get_invoke_request_id(const char* data, size_t size) {
+  return get_extra_id(data, size, kInvokeExtra);
+}
+
+std::string make_paced_send_request(const char* request, size_t size, uint64_t send_id) {
+  return append_extra(request, size, kPacedSendExtra, send_id);
+}
+
+uint64_t get_paced_send_id(const char* data, size_t size) {
+  return get_extra_id(data, size, kPacedSendExtra);
+}
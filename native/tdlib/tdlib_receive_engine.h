@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "tdlib_client_table.h"
+
+class SendPacer;
+
+// TDLib C JSON interface signatures (declared manually to avoid header dependency)
+using td_create_client_id_t = int (*)();
+using td_send_t = void (*)(int, const char*);
+using td_receive_t = const char* (*)(double);
+using td_execute_t = const char* (*)(const char*);
+// Exported by TDLib builds that serialize responses into a reusable buffer
+using td_receive_with_length_t = const char* (*)(double, size_t*);
+// Exported by TDLib builds with a configurable scheduler pool
+using td_set_scheduler_options_t = void (*)(int, int, int, int);
+// Exported by TDLib builds with shared binlog syncing
+using td_set_binlog_sync_delay_t = void (*)(double);
+// Exported by TDLib builds with deferred message search indexing
+using td_set_deferred_message_search_indexing_t = void (*)(int);
+// Exported by TDLib builds with the io_uring poll
+using td_set_use_io_uring_t = void (*)(int);
+// Exported by TDLib builds with the ring file log and per-client log verbosity
+using td_set_use_ring_file_log_t = void (*)(int);
+using td_set_client_log_verbosity_level_t = void (*)(int, int);
+// Exported by TDLib builds with the sampling heap profiler
+using td_set_heap_profile_sample_interval_t = void (*)(size_t);
+using td_get_heap_profile_t = const char* (*)(int);
+// Exported by TDLib builds with the object arena
+using td_set_use_object_arena_t = void (*)(int);
+// Exported by TDLib builds, which can redirect test data centers to a local server
+using td_set_test_dc_server_t = int (*)(const char*, const char*);
+
+// td_receive entry points; receive_with_length is optional
+struct TdReceiveApi {
+  td_receive_t receive{nullptr};
+  td_receive_with_length_t receive_with_length{nullptr};
+
+  // Returns the next response and its length, or nullptr on timeout
+  const char* operator()(double timeout, size_t& size) const;
+};
+
+struct ReceiveEngineOptions {
+  // A batch is handed to the sink as soon as it holds this many updates
+  size_t max_batch_size{256};
+  // A non-empty batch is never held longer than this
+  std::chrono::milliseconds flush_interval{5};
+  // td_receive timeout while there is nothing to flush or expire; bounds the
+  // latency of stop() and of noticing a request registered meanwhile
+  std::chrono::milliseconds idle_timeout{250};
+};
+
+struct ReceivedUpdate {
+  int32_t client_id;
+  std::string data;
+  // Non-zero for the response to a request sent with invoke()
+  uint64_t request_id{0};
+  // The request of request_id expired before TDLib answered; data is empty
+  bool timed_out{false};
+};
+
+using UpdateBatch = std::vector<ReceivedUpdate>;
+
+/**
+ * Background receive loop over the multiplexed td_receive entry point.
+ *
+ * td_receive serves every client created with td_create_client_id and must not
+ * be called from two threads at once, so the engine runs a single receive
+ * thread. Responses are tagged with their "@client_id", accumulated into
+ * batches and handed to the sink from the receive thread. Clients reporting
+ * authorizationStateClosed are marked closed in the client table.
+ *
+ * Updates rejected by a client's UpdateFilter are dropped before they are
+ * copied, and coalesced updates overwrite the earlier update with the same key
+ * in the pending batch, taking over its position.
+ *
+ * Requests sent with invoke() carry an "@extra" made by make_invoke_request.
+ * The engine tracks their deadlines and puts either the matching response or a
+ * timeout marker into the batch, so the JS thread settles each promise once.
+ *
+ * Responses to sends released by the SendPacer are handed to the pacer instead
+ * of the batch, and the pacer also sees every update to learn the outcome of
+ * sent messages.
+ */
+class ReceiveEngine {
+ public:
+  using BatchSink = std::function<void(UpdateBatch&&)>;
+
+  ReceiveEngine(TdReceiveApi receive, ClientTable& clients, UpdateFilterStats& filter_stats, SendPacer& pacer,
+                ReceiveEngineOptions options, BatchSink sink);
+  ~ReceiveEngine();
+
+  ReceiveEngine(const ReceiveEngine&) = delete;
+  ReceiveEngine& operator=(const ReceiveEngine&) = delete;
+
+  void start();
+  void stop();
+
+  // Registers the deadline of an invoke() request right before it is sent;
+  // thread-safe. The registration time starts the response latency clock.
+  void track_request(uint64_t request_id, std::chrono::steady_clock::time_point deadline);
+  bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+  const ReceiveEngineOptions& options() const { return options_; }
+
+ private:
+  using Deadlines = std::multimap<std::chrono::steady_clock::time_point, uint64_t>;
+
+  struct NewRequest {
+    uint64_t request_id;
+    std::chrono::steady_clock::time_point sent_at;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  struct TrackedRequest {
+    Deadlines::iterator deadline;
+    std::chrono::steady_clock::time_point sent_at;
+  };
+
+  void run();
+  void take_new_requests();
+  bool complete_request(uint64_t request_id);
+  void expire_requests(UpdateBatch& batch, std::chrono::steady_clock::time_point now);
+  void add_update(UpdateBatch& batch, int32_t client_id, ClientState* client, const char* data, size_t size);
+  void flush(UpdateBatch& batch);
+
+  TdReceiveApi receive_;
+  ClientTable& clients_;
+  UpdateFilterStats& filter_stats_;
+  SendPacer& pacer_;
+  // Position of the pending update for each coalesce key, per client
+  std::unordered_map<std::string, size_t> coalesced_;
+
+  // Requests registered by the JS thread and not yet seen by the receive thread
+  std::mutex new_requests_mutex_;
+  std::vector<NewRequest> new_requests_;
+  // Owned by the receive thread
+  Deadlines deadlines_;
+  std::unordered_map<uint64_t, TrackedRequest> requests_;
+  ReceiveEngineOptions options_;
+  BatchSink sink_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+};
+
+// Returns whether a JSON object has a top-level "@extra" field
+bool has_extra(const char* request, size_t size);
+
+// Appends the "@extra" of an invoke() request to a JSON object
+std::string make_invoke_request(const char* request, size_t size, uint64_t request_id);
+
+// Returns the invoke() request identifier of a td_receive response, or 0
+uint64_t get_invoke_request_id(const char* data, size_t size);
+
+// Appends the "@extra" of a send released by the SendPacer to a JSON object
+std::string make_paced_send_request(const char* request, size_t size, uint64_t send_id);
+
+// Returns the SendPacer send identifier of a td_receive response, or 0
+uint64_t get_paced_send_id(const char* data, size_t size);
@@ -0,0 +1,479 @@
+#include "tdlib_send_pacer.h"
+
+#include "tdlib_metrics.h"
+#include "tdlib_receive_engine.h"
+#include "tdlib_update_filter.h"
+
+#include <algorithm>
+#include <iterator>
+
+static bool parse_integer(std::string_view json, size_t pos, int64_t& value) {
+  bool is_negative = pos < json.size() && json[pos] == '-';
+  if (is_negative) {
+    pos++;
+  }
+  size_t begin = pos;
+  uint64_t result = 0;
+  while (pos < json.size() && json[pos] >= '0' && json[pos] <= '9' && pos - begin < 19) {
+    result = result * 10 + static_cast<uint64_t>(json[pos] - '0');
+    pos++;
+  }
+  if (pos == begin) {
+    return false;
+  }
+  value = is_negative ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+  return true;
+}
+
+// Quotes inside strings are escaped, so a field name followed by a colon
+// cannot be found inside a string value
+static int64_t get_last_integer_field(std::string_view json, std::string_view field) {
+  size_t pos = json.rfind(field);
+  int64_t value = 0;
+  if (pos == std::string_view::npos || !parse_integer(json, pos + field.size(), value)) {
+    return 0;
+  }
+  return value;
+}
+
+void parse_error(std::string_view json, int32_t& code, std::string& message) {
+  static const std::string_view kCode = "{\"@type\":\"error\",\"code\":";
+  static const std::string_view kMessage = ",\"message\":\"";
+
+  code = 0;
+  message.clear();
+  int64_t value = 0;
+  if (json.compare(0, kCode.size(), kCode) != 0 || !parse_integer(json, kCode.size(), value)) {
+    message = "Unknown error";
+    return;
+  }
+  code = static_cast<int32_t>(value);
+
+  size_t pos = json.find(kMessage, kCode.size());
+  if (pos == std::string_view::npos) {
+    return;
+  }
+  for (pos += kMessage.size(); pos < json.size() && json[pos] != '"'; pos++) {
+    if (json[pos] == '\\' && pos + 1 < json.size()) {
+      pos++;
+    }
+    message += json[pos];
+  }
+}
+
+// Whether the response to sendMessage is a message still being sent
+static bool is_pending_message(std::string_view json) {
+  return json.find("\"sending_state\":{\"@type\":\"messageSendingStatePending\"") != std::string_view::npos;
+}
+
+static int64_t get_message_id(std::string_view json) {
+  static const std::string_view kPrefix = "{\"@type\":\"message\",\"id\":";
+  int64_t value = 0;
+  if (json.compare(0, kPrefix.size(), kPrefix) != 0 || !parse_integer(json, kPrefix.size(), value)) {
+    return 0;
+  }
+  return value;
+}
+
+int32_t get_flood_wait_seconds(int32_t code, std::string_view message) {
+  static const int64_t kMaxWait = 14 * 24 * 60 * 60;
+  static const std::string_view kRetryAfter = "Too Many Requests: retry after ";
+  static const std::string_view kPrefixes[] = {"FLOOD_WAIT_", "SLOWMODE_WAIT_", "FLOOD_PREMIUM_WAIT_"};
+
+  // TDLib reports flood waits it does not wait out itself as 429 errors;
+  // the other forms are passed through for some requests
+  size_t pos = 0;
+  if (code == 429 && message.compare(0, kRetryAfter.size(), kRetryAfter) == 0) {
+    pos = kRetryAfter.size();
+  } else {
+    for (auto prefix : kPrefixes) {
+      if (message.compare(0, prefix.size(), prefix) == 0) {
+        pos = prefix.size();
+        break;
+      }
+    }
+  }
+  int64_t seconds = 0;
+  if (pos == 0 || !parse_integer(message, pos, seconds)) {
+    return 0;
+  }
+  return static_cast<int32_t>(std::min(std::max<int64_t>(seconds, 1), kMaxWait));
+}
+
+SendPacer::~SendPacer() {
+  stop();
+}
+
+bool SendPacer::start(SendFunction send, SendPacerOptions options, ResultSink sink) {
+  bool expected = false;
+  if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+    return false;
+  }
+  send_ = std::move(send);
+  options_ = options;
+  options_.max_in_flight = std::max<size_t>(1, options_.max_in_flight);
+  options_.send_timeout = std::max(options_.send_timeout, std::chrono::milliseconds(1));
+  options_.max_retries = std::max(0, options_.max_retries);
+  options_.max_batch_size = std::max<size_t>(1, options_.max_batch_size);
+  options_.flush_interval = std::max(options_.flush_interval, std::chrono::milliseconds(1));
+  sink_ = std::move(sink);
+  thread_ = std::thread([this] { run(); });
+  return true;
+}
+
+void SendPacer::stop() {
+  bool expected = true;
+  if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
+    return;
+  }
+  {
+    auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+    wake_up();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+
+  PacedSendResultBatch results;
+  {
+    auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+    for (auto& it : in_flight_) {
+      add_result(it.second.send, it.second.client_id, PacedSendResult::Status::Cancelled, 0, std::string());
+    }
+    in_flight_.clear();
+    awaited_messages_.clear();
+    awaited_message_count_.store(0, std::memory_order_relaxed);
+    for (auto& it : accounts_) {
+      for (const auto& send : it.second.queue) {
+        add_result(send, it.first, PacedSendResult::Status::Cancelled, 0, std::string());
+      }
+      it.second.queue.clear();
+      it.second.in_flight = 0;
+    }
+    results.swap(results_);
+  }
+  if (!results.empty()) {
+    sink_(std::move(results));
+  }
+}
+
+uint64_t SendPacer::enqueue(int32_t client_id, std::vector<std::string> requests, const SendPacing* pacing) {
+  auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+  Account& account = accounts_[client_id];
+  bool is_new = account.rate == 0;
+  if (pacing != nullptr) {
+    account.pacing = *pacing;
+    account.pacing.rate = std::max(0.001, account.pacing.rate);
+    account.pacing.burst = std::max(1.0, account.pacing.burst);
+    account.rate = account.pacing.rate;
+  }
+  if (is_new) {
+    account.rate = account.pacing.rate;
+    account.tokens = account.pacing.burst;
+    account.refilled_at = clock::now();
+  }
+  account.tokens = std::min(account.tokens, account.pacing.burst);
+
+  uint64_t batch_id = ++next_batch_id_;
+  for (size_t i = 0; i < requests.size(); i++) {
+    account.queue.push_back(QueuedSend{batch_id, static_cast<uint32_t>(i), 0, std::move(requests[i])});
+  }
+  wake_up();
+  return batch_id;
+}
+
+size_t SendPacer::cancel(uint64_t batch_id) {
+  auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+  size_t count = 0;
+  for (auto& it : accounts_) {
+    auto& queue = it.second.queue;
+    auto is_cancelled = [batch_id](const QueuedSend& send) { return send.batch_id == batch_id; };
+    for (const auto& send : queue) {
+      if (is_cancelled(send)) {
+        add_result(send, it.first, PacedSendResult::Status::Cancelled, 0, std::string());
+        count++;
+      }
+    }
+    queue.erase(std::remove_if(queue.begin(), queue.end(), is_cancelled), queue.end());
+  }
+  if (count != 0) {
+    wake_up();
+  }
+  return count;
+}
+
+void SendPacer::on_response(int32_t client_id, uint64_t send_id, const char* data, size_t size) {
+  std::string_view json(data, size);
+  auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+  auto it = in_flight_.find(send_id);
+  if (it == in_flight_.end()) {
+    // Already timed out or cancelled
+    return;
+  }
+
+  std::string_view type = get_response_type(data, size);
+  if (type == "error") {
+    int32_t code = 0;
+    std::string message;
+    parse_error(json, code, message);
+    fail(it, code, std::move(message));
+    return;
+  }
+  if (type == "message" && is_pending_message(json)) {
+    int64_t message_id = get_message_id(json);
+    if (message_id != 0 && awaited_messages_.emplace(std::make_pair(client_id, message_id), send_id).second) {
+      it->second.message_id = message_id;
+      awaited_message_count_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  finish(it, PacedSendResult::Status::Sent, 0, std::string(data, size));
+}
+
+void SendPacer::on_update(int32_t client_id, const char* data, size_t size) {
+  if (awaited_message_count_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::string_view type = get_response_type(data, size);
+  bool is_succeeded = type == "updateMessageSendSucceeded";
+  if (!is_succeeded && type != "updateMessageSendFailed") {
+    return;
+  }
+
+  // The fields old_message_id and error follow the potentially big message
+  std::string_view json(data, size);
+  int64_t old_message_id = get_last_integer_field(json, "\"old_message_id\":");
+  if (old_message_id == 0) {
+    return;
+  }
+  auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+  auto awaited = awaited_messages_.find(std::make_pair(client_id, old_message_id));
+  if (awaited == awaited_messages_.end()) {
+    return;
+  }
+  auto it = in_flight_.find(awaited->second);
+  if (is_succeeded) {
+    finish(it, PacedSendResult::Status::Sent, 0, std::string(data, size));
+    return;
+  }
+
+  static const std::string_view kError = "\"error\":{";
+  int32_t code = 0;
+  std::string message;
+  size_t pos = json.rfind(kError);
+  parse_error(pos == std::string_view::npos ? std::string_view() : json.substr(pos + kError.size() - 1), code,
+              message);
+  fail(it, code, std::move(message));
+}
+
+std::vector<SendPacerAccountStats> SendPacer::get_stats() const {
+  auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+  auto now = clock::now();
+  std::vector<SendPacerAccountStats> stats;
+  stats.reserve(accounts_.size());
+  for (const auto& it : accounts_) {
+    const Account& account = it.second;
+    auto paused_for = account.paused_until > now ? std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                       account.paused_until - now)
+                                                 : std::chrono::milliseconds(0);
+    stats.push_back(SendPacerAccountStats{it.first, account.queue.size(), account.in_flight, account.rate,
+                                          paused_for, account.sent, account.failed, account.flood_waits});
+  }
+  return stats;
+}
+
+void SendPacer::refill(Account& account, clock::time_point now) {
+  if (now > account.refilled_at) {
+    double elapsed = std::chrono::duration<double>(now - account.refilled_at).count();
+    account.tokens = std::min(account.pacing.burst, account.tokens + elapsed * account.rate);
+    account.refilled_at = now;
+  }
+}
+
+bool SendPacer::can_release(Account& account, clock::time_point now) {
+  if (account.queue.empty() || now < account.paused_until) {
+    return false;
+  }
+  refill(account, now);
+  return account.tokens >= 1;
+}
+
+SendPacer::clock::time_point SendPacer::release_sends(clock::time_point now,
+                                                      std::vector<std::pair<int32_t, std::string>>& sends) {
+  // Every pass releases at most one send of each account
+  bool is_released = true;
+  while (is_released && in_flight_.size() < options_.max_in_flight) {
+    is_released = false;
+    auto it = accounts_.upper_bound(last_client_id_);
+    for (size_t i = 0; i < accounts_.size() && in_flight_.size() < options_.max_in_flight; i++, ++it) {
+      if (it == accounts_.end()) {
+        it = accounts_.begin();
+      }
+      Account& account = it->second;
+      if (!can_release(account, now)) {
+        continue;
+      }
+
+      QueuedSend send = std::move(account.queue.front());
+      account.queue.pop_front();
+      account.tokens -= 1;
+      account.in_flight++;
+      send.attempts++;
+      uint64_t send_id = ++next_send_id_;
+      sends.emplace_back(it->first, make_paced_send_request(send.request.data(), send.request.size(), send_id));
+      in_flight_.emplace(send_id, InFlightSend{it->first, std::move(send), now + options_.send_timeout});
+      last_client_id_ = it->first;
+      is_released = true;
+    }
+  }
+
+  clock::time_point next_release = now + std::chrono::seconds(1);
+  if (in_flight_.size() >= options_.max_in_flight) {
+    // A finished send wakes the pacer up
+    return next_release;
+  }
+  for (const auto& it : accounts_) {
+    const Account& account = it.second;
+    if (account.queue.empty()) {
+      continue;
+    }
+    if (account.paused_until > now) {
+      next_release = std::min(next_release, account.paused_until);
+    } else {
+      auto wait = std::chrono::duration<double>((1 - account.tokens) / account.rate);
+      next_release = std::min(next_release, now + std::chrono::duration_cast<clock::duration>(wait));
+    }
+  }
+  return next_release;
+}
+
+void SendPacer::expire_sends(clock::time_point now) {
+  for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+    auto next = std::next(it);
+    if (it->second.deadline <= now) {
+      finish(it, PacedSendResult::Status::TimedOut, 0, std::string());
+    }
+    it = next;
+  }
+}
+
+void SendPacer::erase_idle_accounts(clock::time_point now) {
+  // Forgetting an account with a partly refilled bucket would grant it a new burst
+  for (auto it = accounts_.begin(); it != accounts_.end();) {
+    Account& account = it->second;
+    if (account.queue.empty() && account.in_flight == 0 && account.paused_until <= now) {
+      refill(account, now);
+      if (account.tokens >= account.pacing.burst) {
+        it = accounts_.erase(it);
+        continue;
+      }
+    }
+    ++it;
+  }
+}
+
+void SendPacer::finish(std::unordered_map<uint64_t, InFlightSend>::iterator it, PacedSendResult::Status status,
+                       int32_t error_code, std::string data) {
+  int32_t client_id = it->second.client_id;
+  Account& account = accounts_[client_id];
+  account.in_flight--;
+  if (status == PacedSendResult::Status::Sent) {
+    account.sent++;
+    account.rate = std::min(account.pacing.rate, account.rate + account.pacing.rate / 32);
+  } else {
+    account.failed++;
+  }
+  if (it->second.message_id != 0) {
+    awaited_messages_.erase(std::make_pair(client_id, it->second.message_id));
+    awaited_message_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  add_result(it->second.send, client_id, status, error_code, std::move(data));
+  in_flight_.erase(it);
+  wake_up();
+}
+
+void SendPacer::fail(std::unordered_map<uint64_t, InFlightSend>::iterator it, int32_t error_code,
+                     std::string message) {
+  int32_t wait = get_flood_wait_seconds(error_code, message);
+  if (wait == 0) {
+    finish(it, PacedSendResult::Status::Failed, error_code, std::move(message));
+    return;
+  }
+
+  int32_t client_id = it->second.client_id;
+  Account& account = accounts_[client_id];
+  account.flood_waits++;
+  account.paused_until = std::max(account.paused_until, clock::now() + std::chrono::seconds(wait));
+  account.tokens = 0;
+  account.refilled_at = account.paused_until;
+  account.rate = std::max(account.pacing.rate / 16, account.rate / 2);
+  if (it->second.send.attempts > options_.max_retries) {
+    finish(it, PacedSendResult::Status::Failed, error_code, std::move(message));
+    return;
+  }
+
+  account.in_flight--;
+  if (it->second.message_id != 0) {
+    awaited_messages_.erase(std::make_pair(client_id, it->second.message_id));
+    awaited_message_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  account.queue.push_front(std::move(it->second.send));
+  in_flight_.erase(it);
+  wake_up();
+}
+
+void SendPacer::add_result(const QueuedSend& send, int32_t client_id, PacedSendResult::Status status,
+                           int32_t error_code, std::string data) {
+  if (results_.empty()) {
+    results_deadline_ = clock::now() + options_.flush_interval;
+  }
+  results_.push_back(
+      PacedSendResult{send.batch_id, send.index, client_id, status, send.attempts, error_code, std::move(data)});
+}
+
+// Must be called with the mutex held
+void SendPacer::wake_up() {
+  has_changes_ = true;
+  wake_up_cv_.notify_one();
+}
+
+void SendPacer::run() {
+  std::vector<std::pair<int32_t, std::string>> sends;
+  PacedSendResultBatch results;
+  while (running_.load(std::memory_order_acquire)) {
+    clock::time_point wake_up_at;
+    {
+      auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+      auto now = clock::now();
+      expire_sends(now);
+      has_changes_ = false;
+      wake_up_at = release_sends(now, sends);
+      erase_idle_accounts(now);
+      for (const auto& it : in_flight_) {
+        wake_up_at = std::min(wake_up_at, it.second.deadline);
+      }
+      if (!results_.empty()) {
+        if (results_.size() >= options_.max_batch_size || now >= results_deadline_) {
+          results.swap(results_);
+        } else {
+          wake_up_at = std::min(wake_up_at, results_deadline_);
+        }
+      }
+    }
+
+    // Sends are registered before they are released, so the receive thread
+    // always finds them
+    for (const auto& send : sends) {
+      send_(send.first, send.second);
+    }
+    sends.clear();
+    if (!results.empty()) {
+      sink_(std::move(results));
+      results = PacedSendResultBatch();
+    }
+
+    auto lock = lock_timed(mutex_, AddonLock::SendPacer);
+    wake_up_cv_.wait_until(lock, wake_up_at,
+                           [this] { return has_changes_ || !running_.load(std::memory_order_acquire); });
+  }
+}
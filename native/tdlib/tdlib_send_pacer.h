@@ -0,0 +1,191 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct SendPacerOptions {
+  // Sends released to TDLib and not finished yet, over all accounts
+  size_t max_in_flight{64};
+  // A send TDLib has not finished in this time is reported as timed out
+  std::chrono::milliseconds send_timeout{60000};
+  // Times a send is repeated after a flood wait before it is reported as failed
+  int32_t max_retries{3};
+  // A batch of results is handed to the sink as soon as it holds this many results
+  size_t max_batch_size{256};
+  // A non-empty batch of results is never held longer than this
+  std::chrono::milliseconds flush_interval{100};
+};
+
+// Send rate of one account
+struct SendPacing {
+  double rate{20};
+  // Sends released at once after the account has been idle
+  double burst{1};
+};
+
+struct PacedSendResult {
+  enum class Status : uint8_t { Sent, Failed, TimedOut, Cancelled };
+
+  uint64_t batch_id;
+  uint32_t index;
+  int32_t client_id;
+  Status status;
+  int32_t attempts;
+  int32_t error_code{0};
+  // The final response or update of a sent request, or the error message of a failed one
+  std::string data;
+};
+
+using PacedSendResultBatch = std::vector<PacedSendResult>;
+
+struct SendPacerAccountStats {
+  int32_t client_id;
+  size_t queued;
+  size_t in_flight;
+  // Current rate, lowered after flood waits
+  double rate;
+  std::chrono::milliseconds paused_for;
+  uint64_t sent;
+  uint64_t failed;
+  uint64_t flood_waits;
+};
+
+/**
+ * Releases queued requests of many accounts to td_send at a per-account rate.
+ *
+ * Each account is a token bucket refilled at its rate; accounts are served
+ * round-robin while fewer than max_in_flight sends are unfinished. A send is
+ * finished by its response, or, for a sendMessage answered with a pending
+ * message, by updateMessageSendSucceeded or updateMessageSendFailed, both
+ * observed on the receive thread. A flood wait (FLOOD_WAIT_N, SLOWMODE_WAIT_N
+ * or TDLib's "Too Many Requests: retry after N") pauses only the account that
+ * got it for N seconds, halves its rate and puts the send back at the head of
+ * its queue; every successful send then raises the rate back towards the
+ * configured one. Results are handed to the sink in batches from the pacer
+ * thread. An account is forgotten, together with its pacing and statistics,
+ * once it has nothing queued or in flight, is not paused and its bucket is
+ * full again, so that closed clients do not accumulate.
+ */
+class SendPacer {
+ public:
+  using SendFunction = std::function<void(int32_t client_id, const std::string& request)>;
+  using ResultSink = std::function<void(PacedSendResultBatch&&)>;
+
+  SendPacer() = default;
+  ~SendPacer();
+
+  SendPacer(const SendPacer&) = delete;
+  SendPacer& operator=(const SendPacer&) = delete;
+
+  // Returns false if the pacer is already running
+  bool start(SendFunction send, SendPacerOptions options, ResultSink sink);
+  // Joins the pacer thread; queued and unfinished sends are reported as cancelled
+  void stop();
+  bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+  const SendPacerOptions& options() const { return options_; }
+
+  // Queues requests of one account and returns their batch identifier;
+  // thread-safe. A non-null pacing replaces the rate of the account.
+  uint64_t enqueue(int32_t client_id, std::vector<std::string> requests, const SendPacing* pacing);
+
+  // Drops the sends of a batch that are not released yet, reporting them as
+  // cancelled; returns their number
+  size_t cancel(uint64_t batch_id);
+
+  // Called on the receive thread with a response to a paced send
+  void on_response(int32_t client_id, uint64_t send_id, const char* data, size_t size);
+
+  // Called on the receive thread with every update
+  void on_update(int32_t client_id, const char* data, size_t size);
+
+  std::vector<SendPacerAccountStats> get_stats() const;
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  struct QueuedSend {
+    uint64_t batch_id;
+    uint32_t index;
+    int32_t attempts;
+    std::string request;
+  };
+
+  struct Account {
+    SendPacing pacing;
+    double rate{0};
+    double tokens{0};
+    clock::time_point refilled_at;
+    clock::time_point paused_until;
+    std::deque<QueuedSend> queue;
+    size_t in_flight{0};
+    uint64_t sent{0};
+    uint64_t failed{0};
+    uint64_t flood_waits{0};
+  };
+
+  struct InFlightSend {
+    int32_t client_id;
+    QueuedSend send;
+    clock::time_point deadline;
+    // Identifier of the pending message whose outcome is awaited, or 0
+    int64_t message_id{0};
+  };
+
+  void run();
+  // Releases sends allowed by rates and the in-flight limit; returns the time
+  // the next send may be released
+  clock::time_point release_sends(clock::time_point now, std::vector<std::pair<int32_t, std::string>>& sends);
+  static void refill(Account& account, clock::time_point now);
+  bool can_release(Account& account, clock::time_point now);
+  void expire_sends(clock::time_point now);
+  void erase_idle_accounts(clock::time_point now);
+  void finish(std::unordered_map<uint64_t, InFlightSend>::iterator it, PacedSendResult::Status status,
+              int32_t error_code, std::string data);
+  void fail(std::unordered_map<uint64_t, InFlightSend>::iterator it, int32_t error_code, std::string message);
+  void add_result(const QueuedSend& send, int32_t client_id, PacedSendResult::Status status, int32_t error_code,
+                  std::string data);
+  void wake_up();
+
+  SendFunction send_;
+  SendPacerOptions options_;
+  ResultSink sink_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_up_cv_;
+  bool has_changes_{false};
+  std::map<int32_t, Account> accounts_;
+  // Round-robin position among accounts
+  int32_t last_client_id_{0};
+  std::unordered_map<uint64_t, InFlightSend> in_flight_;
+  // Send identifier of pending messages by client and message identifier
+  std::map<std::pair<int32_t, int64_t>, uint64_t> awaited_messages_;
+  std::atomic<size_t> awaited_message_count_{0};
+  PacedSendResultBatch results_;
+  clock::time_point results_deadline_;
+  uint64_t next_batch_id_{0};
+  uint64_t next_send_id_{0};
+};
+
+// Parses an object of the type error, which has the fields code and message;
+// the code is 0 and the message "Unknown error" if the object is not an error
+void parse_error(std::string_view json, int32_t& code, std::string& message);
+
+// Returns the number of seconds to wait before repeating a request failed
+// with the given TDLib error, or 0 if the error is not a flood wait
+int32_t get_flood_wait_seconds(int32_t code, std::string_view message);
@@ -0,0 +1,378 @@
+// Behaviour tests of the SendPacer: rates, round-robin, flood waits and the
+// completion of sends, driven by a fake td_send and synthetic responses.
+// Needs no libtdjson.
+
+#include "tdlib_receive_engine.h"
+#include "tdlib_send_pacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+template <class T>
+static void check_equal(const std::string& name, const T& actual, const T& expected) {
+  if (!(actual == expected)) {
+    std::cerr << "FAIL: " << name << ": got [" << actual << "], expected [" << expected << "]" << std::endl;
+    failures++;
+  }
+}
+
+static void check(const std::string& name, bool condition) {
+  if (!condition) {
+    std::cerr << "FAIL: " << name << std::endl;
+    failures++;
+  }
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct SentRequest {
+  int32_t client_id;
+  uint64_t send_id;
+  std::string request;
+  Clock::time_point sent_at;
+};
+
+/**
+ * Stands in for td_send and the receive thread: records released sends,
+ * answers them with the responses chosen by respond, and collects results.
+ */
+class FakeTd {
+ public:
+  // Returns the response to a released send, or an empty string to leave it unanswered
+  using Responder = std::function<std::string(const SentRequest&)>;
+
+  explicit FakeTd(SendPacerOptions options, Responder respond = nullptr) : respond_(std::move(respond)) {
+    options.flush_interval = std::chrono::milliseconds(1);
+    pacer_.start([this](int32_t client_id, const std::string& request) { on_send(client_id, request); }, options,
+                 [this](PacedSendResultBatch&& batch) {
+                   std::lock_guard<std::mutex> lock(mutex_);
+                   for (auto& result : batch) {
+                     results_.push_back(std::move(result));
+                   }
+                   changed_.notify_all();
+                 });
+  }
+
+  ~FakeTd() { pacer_.stop(); }
+
+  SendPacer& pacer() { return pacer_; }
+
+  void respond(const SentRequest& sent, const std::string& response) {
+    pacer_.on_response(sent.client_id, sent.send_id, response.data(), response.size());
+  }
+
+  void update(int32_t client_id, const std::string& update) {
+    pacer_.on_update(client_id, update.data(), update.size());
+  }
+
+  // Waits until the condition holds for the sends and results seen so far
+  bool wait_for(const std::function<bool(const std::vector<SentRequest>&, const PacedSendResultBatch&)>& condition,
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [&] { return condition(sent_, results_); });
+  }
+
+  bool wait_for_sends(size_t count) {
+    return wait_for([count](const auto& sent, const auto&) { return sent.size() >= count; });
+  }
+
+  bool wait_for_results(size_t count) {
+    return wait_for([count](const auto&, const auto& results) { return results.size() >= count; });
+  }
+
+  std::vector<SentRequest> sent() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_;
+  }
+
+  PacedSendResultBatch results() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+  }
+
+  bool has_account(int32_t client_id) {
+    auto stats = pacer_.get_stats();
+    return std::any_of(stats.begin(), stats.end(), [client_id](const auto& it) { return it.client_id == client_id; });
+  }
+
+  SendPacerAccountStats stats(int32_t client_id) {
+    for (const auto& stats : pacer_.get_stats()) {
+      if (stats.client_id == client_id) {
+        return stats;
+      }
+    }
+    return SendPacerAccountStats{client_id, 0, 0, 0, std::chrono::milliseconds(0), 0, 0, 0};
+  }
+
+ private:
+  void on_send(int32_t client_id, const std::string& request) {
+    // The receive thread finds the send identifier next to the "@client_id" TDLib appends
+    std::string response = request.substr(0, request.size() - 1) + ",\"@client_id\":" + std::to_string(client_id) + "}";
+    SentRequest sent{client_id, get_paced_send_id(response.data(), response.size()), request, Clock::now()};
+    // A send is seen by the tests only after its response is handled
+    if (respond_) {
+      std::string reply = respond_(sent);
+      if (!reply.empty()) {
+        respond(sent, reply);
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_.push_back(sent);
+    changed_.notify_all();
+  }
+
+  Responder respond_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::vector<SentRequest> sent_;
+  PacedSendResultBatch results_;
+  SendPacer pacer_;
+};
+
+static const std::string kOk = R"({"@type":"ok"})";
+
+static std::vector<std::string> make_requests(size_t count) {
+  std::vector<std::string> requests;
+  for (size_t i = 0; i < count; i++) {
+    requests.push_back(R"({"@type":"getOption","name":"n)" + std::to_string(i) + R"("})");
+  }
+  return requests;
+}
+
+static double milliseconds_between(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static const PacedSendResult* find_result(const PacedSendResultBatch& results, uint64_t batch_id, uint32_t index) {
+  for (const auto& result : results) {
+    if (result.batch_id == batch_id && result.index == index) {
+      return &result;
+    }
+  }
+  return nullptr;
+}
+
+static void test_rate_and_burst() {
+  FakeTd td(SendPacerOptions(), [](const SentRequest&) { return kOk; });
+  SendPacing pacing{20, 3};
+  td.pacer().enqueue(1, make_requests(6), &pacing);
+
+  check("rate: all sends finish", td.wait_for_results(6));
+  auto sent = td.sent();
+  check_equal(std::string("rate: sends released"), sent.size(), static_cast<size_t>(6));
+  if (sent.size() != 6) {
+    return;
+  }
+  // The burst is released at once, then one send per 50 ms
+  check("rate: burst released at once", milliseconds_between(sent[0].sent_at, sent[2].sent_at) < 30);
+  check("rate: send after the burst waits for a token", milliseconds_between(sent[0].sent_at, sent[3].sent_at) >= 35);
+  check("rate: later sends are paced", milliseconds_between(sent[0].sent_at, sent[5].sent_at) >= 130);
+  for (const auto& result : td.results()) {
+    check_equal(std::string("rate: status"), static_cast<int>(result.status),
+                static_cast<int>(PacedSendResult::Status::Sent));
+    check_equal(std::string("rate: attempts"), result.attempts, 1);
+  }
+}
+
+static void test_round_robin() {
+  SendPacerOptions options;
+  options.max_in_flight = 2;
+  FakeTd td(options);
+  SendPacing pacing{1000, 10};
+  for (int32_t client_id : {1, 2, 3}) {
+    td.pacer().enqueue(client_id, make_requests(3), &pacing);
+  }
+
+  // Every response frees one slot, which goes to the next account in turn
+  size_t max_in_flight = 0;
+  for (size_t answered = 0; answered < 9; answered++) {
+    check("round-robin: send released", td.wait_for_sends(std::min<size_t>(answered + 2, 9)));
+    auto sent = td.sent();
+    max_in_flight = std::max(max_in_flight, sent.size() - answered);
+    if (answered < sent.size()) {
+      td.respond(sent[answered], kOk);
+    }
+  }
+  check("round-robin: all sends finish", td.wait_for_results(9));
+
+  check_equal(std::string("round-robin: in flight"), max_in_flight, static_cast<size_t>(2));
+  std::string order;
+  for (const auto& sent : td.sent()) {
+    order += std::to_string(sent.client_id);
+  }
+  check_equal(std::string("round-robin: order"), order, std::string("123123123"));
+}
+
+static void test_flood_wait() {
+  FakeTd td(SendPacerOptions(), [](const SentRequest& sent) {
+    static bool is_flood_wait_sent = false;
+    if (sent.client_id == 1 && !is_flood_wait_sent) {
+      is_flood_wait_sent = true;
+      return std::string(R"({"@type":"error","code":429,"message":"Too Many Requests: retry after 1"})");
+    }
+    return kOk;
+  });
+  // One send at a time, so the flood wait arrives before the next send of the account is released
+  SendPacing first_pacing{1000, 1};
+  SendPacing second_pacing{1000, 10};
+  uint64_t first_batch = td.pacer().enqueue(1, make_requests(3), &first_pacing);
+  uint64_t second_batch = td.pacer().enqueue(2, make_requests(3), &second_pacing);
+
+  // The other account is not paused
+  check("flood wait: other account finishes", td.wait_for([second_batch](const auto&, const auto& results) {
+    return std::count_if(results.begin(), results.end(),
+                         [second_batch](const auto& result) { return result.batch_id == second_batch; }) == 3;
+  }));
+  auto stats = td.stats(1);
+  check_equal(std::string("flood wait: flood waits"), stats.flood_waits, static_cast<uint64_t>(1));
+  check_equal(std::string("flood wait: rate halved"), stats.rate, 500.0);
+  check("flood wait: account paused", stats.paused_for.count() > 500);
+  check_equal(std::string("flood wait: requeued"), stats.queued, static_cast<size_t>(3));
+  check_equal(std::string("flood wait: nothing reported"), find_result(td.results(), first_batch, 0) == nullptr, true);
+
+  check("flood wait: paused account finishes", td.wait_for_results(6));
+  std::vector<SentRequest> first_sends;
+  for (const auto& sent : td.sent()) {
+    if (sent.client_id == 1) {
+      first_sends.push_back(sent);
+    }
+  }
+  check_equal(std::string("flood wait: sends of the paused account"), first_sends.size(), static_cast<size_t>(4));
+  if (first_sends.size() == 4) {
+    // The failed send is repeated first, after the wait
+    check("flood wait: retried after the wait",
+          milliseconds_between(first_sends[0].sent_at, first_sends[1].sent_at) >= 900);
+    auto untagged = [](const std::string& request) { return request.substr(0, request.rfind(",\"@extra\"")); };
+    check_equal(std::string("flood wait: retried at the head"), untagged(first_sends[1].request),
+                untagged(first_sends[0].request));
+  }
+  auto results = td.results();
+  const PacedSendResult* retried = find_result(results, first_batch, 0);
+  check("flood wait: retried send reported", retried != nullptr);
+  if (retried != nullptr) {
+    check_equal(std::string("flood wait: retried status"), static_cast<int>(retried->status),
+                static_cast<int>(PacedSendResult::Status::Sent));
+    check_equal(std::string("flood wait: retried attempts"), retried->attempts, 2);
+  }
+}
+
+static void test_message_send_updates() {
+  static const std::string kPending =
+      R"({"@type":"message","id":%ID%,"chat_id":5,"sending_state":{"@type":"messageSendingStatePending"}})";
+  FakeTd td(SendPacerOptions(), [](const SentRequest& sent) {
+    std::string response = kPending;
+    response.replace(response.find("%ID%"), 4, std::to_string(100 + sent.send_id));
+    return response;
+  });
+  SendPacing pacing{1000, 10};
+  const std::string request = R"({"@type":"sendMessage","chat_id":5})";
+  uint64_t batch_id = td.pacer().enqueue(1, {request, request}, &pacing);
+  check("updates: sends released", td.wait_for_sends(2));
+  auto sent = td.sent();
+  if (sent.size() != 2) {
+    return;
+  }
+
+  // A pending message finishes only with its updateMessageSendSucceeded or updateMessageSendFailed
+  check_equal(std::string("updates: in flight"), td.stats(1).in_flight, static_cast<size_t>(2));
+  std::string first_id = std::to_string(100 + sent[0].send_id);
+  std::string second_id = std::to_string(100 + sent[1].send_id);
+  td.update(2, R"({"@type":"updateMessageSendSucceeded","message":{"@type":"message","id":1},"old_message_id":)" +
+                   first_id + "}");
+  td.update(1, R"({"@type":"updateMessageSendSucceeded","message":{"@type":"message","id":1},"old_message_id":)" +
+                   first_id + "}");
+  td.update(1, R"({"@type":"updateMessageSendFailed","message":{"@type":"message","id":2},"old_message_id":)" +
+                   second_id + R"(,"error":{"@type":"error","code":400,"message":"CHAT_WRITE_FORBIDDEN"}})");
+  check("updates: sends finish", td.wait_for_results(2));
+
+  auto results = td.results();
+  const PacedSendResult* succeeded = find_result(results, batch_id, 0);
+  const PacedSendResult* failed = find_result(results, batch_id, 1);
+  check("updates: results reported", succeeded != nullptr && failed != nullptr);
+  if (succeeded != nullptr && failed != nullptr) {
+    check_equal(std::string("updates: succeeded status"), static_cast<int>(succeeded->status),
+                static_cast<int>(PacedSendResult::Status::Sent));
+    check("updates: succeeded data", succeeded->data.find("updateMessageSendSucceeded") != std::string::npos);
+    check_equal(std::string("updates: failed status"), static_cast<int>(failed->status),
+                static_cast<int>(PacedSendResult::Status::Failed));
+    check_equal(std::string("updates: failed code"), failed->error_code, 400);
+    check_equal(std::string("updates: failed message"), failed->data, std::string("CHAT_WRITE_FORBIDDEN"));
+  }
+  check_equal(std::string("updates: nothing in flight"), td.stats(1).in_flight, static_cast<size_t>(0));
+}
+
+static void test_timeout_and_cancel() {
+  SendPacerOptions options;
+  options.send_timeout = std::chrono::milliseconds(50);
+  FakeTd td(options);
+  SendPacing pacing{1, 1};
+  uint64_t batch_id = td.pacer().enqueue(1, make_requests(5), &pacing);
+  check("cancel: first send released", td.wait_for_sends(1));
+
+  // Only the queued sends are cancelled; the released one times out unanswered
+  check_equal(std::string("cancel: cancelled"), td.pacer().cancel(batch_id), static_cast<size_t>(4));
+  check_equal(std::string("cancel: cancelled again"), td.pacer().cancel(batch_id), static_cast<size_t>(0));
+  check("timeout: send times out", td.wait_for_results(5));
+
+  auto results = td.results();
+  for (uint32_t index = 0; index < 5; index++) {
+    const PacedSendResult* result = find_result(results, batch_id, index);
+    check("cancel: result " + std::to_string(index), result != nullptr);
+    if (result != nullptr) {
+      auto expected = index == 0 ? PacedSendResult::Status::TimedOut : PacedSendResult::Status::Cancelled;
+      check_equal("cancel: status " + std::to_string(index), static_cast<int>(result->status),
+                  static_cast<int>(expected));
+    }
+  }
+  check_equal(std::string("cancel: sends released"), td.sent().size(), static_cast<size_t>(1));
+
+  // A late response to a timed out send is ignored
+  td.respond(td.sent()[0], kOk);
+  check_equal(std::string("timeout: late response ignored"), td.results().size(), static_cast<size_t>(5));
+}
+
+static void test_idle_accounts_forgotten() {
+  FakeTd td(SendPacerOptions(), [](const SentRequest&) { return kOk; });
+  SendPacing fast{1000, 1};
+  SendPacing slow{1, 1};
+  td.pacer().enqueue(1, make_requests(2), &fast);
+  td.pacer().enqueue(2, make_requests(1), &slow);
+  check("idle: sends finish", td.wait_for_results(3));
+
+  // The slow account needs a second to refill its bucket
+  check("idle: refilling account kept", td.has_account(2));
+  bool is_forgotten = false;
+  for (int i = 0; i < 300 && !is_forgotten; i++) {
+    is_forgotten = !td.has_account(1) && !td.has_account(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  check("idle: accounts forgotten", is_forgotten);
+
+  td.pacer().enqueue(1, make_requests(1), nullptr);
+  check("idle: forgotten account sends again", td.wait_for_results(4));
+}
+
+int main() {
+  test_rate_and_burst();
+  test_round_robin();
+  test_flood_wait();
+  test_message_send_updates();
+  test_timeout_and_cancel();
+  test_idle_accounts_forgotten();
+
+  if (failures > 0) {
+    std::cerr << "FAILED: " << failures << " checks failed" << std::endl;
+    return 1;
+  }
+  std::cout << "SUCCESS: All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "tdlib_update_filter.h"
+
+#include "tdlib_metrics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+static void sort_unique(std::vector<std::string>& values) {
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+static bool contains(const std::vector<std::string>& sorted, std::string_view value) {
+  auto it = std::lower_bound(sorted.begin(), sorted.end(), value,
+                             [](const std::string& lhs, std::string_view rhs) { return lhs < rhs; });
+  return it != sorted.end() && *it == value;
+}
+
+static bool is_filterable_type(std::string_view type) {
+  static const std::string_view kUpdatePrefix = "update";
+  return type.size() > kUpdatePrefix.size() && type.compare(0, kUpdatePrefix.size(), kUpdatePrefix) == 0 &&
+         type != "updateAuthorizationState";
+}
+
+UpdateFilter::UpdateFilter(Mode mode, std::vector<std::string> types, std::vector<std::string> coalesce_types)
+    : mode_(mode), types_(std::move(types)), coalesce_types_(std::move(coalesce_types)) {
+  sort_unique(types_);
+  sort_unique(coalesce_types_);
+}
+
+bool UpdateFilter::accepts(std::string_view type) const {
+  if (!is_filterable_type(type)) {
+    return true;
+  }
+  return contains(types_, type) == (mode_ == Mode::Allow);
+}
+
+bool UpdateFilter::coalesces(std::string_view type) const {
+  return is_filterable_type(type) && contains(coalesce_types_, type);
+}
+
+void UpdateFilterStats::add_dropped(std::string_view type) {
+  auto lock = lock_timed(mutex_, AddonLock::FilterStats);
+  auto it = counters_.find(type);
+  if (it == counters_.end()) {
+    it = counters_.emplace(std::string(type), Counters()).first;
+  }
+  it->second.dropped++;
+}
+
+void UpdateFilterStats::add_coalesced(std::string_view type) {
+  auto lock = lock_timed(mutex_, AddonLock::FilterStats);
+  auto it = counters_.find(type);
+  if (it == counters_.end()) {
+    it = counters_.emplace(std::string(type), Counters()).first;
+  }
+  it->second.coalesced++;
+}
+
+std::map<std::string, UpdateFilterStats::Counters> UpdateFilterStats::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::map<std::string, Counters>(counters_.begin(), counters_.end());
+}
+
+std::string_view get_response_type(const char* data, size_t size) {
+  static const char kPrefix[] = "{\"@type\":\"";
+  static const size_t kPrefixSize = sizeof(kPrefix) - 1;
+
+  // TDLib always serializes @type as the first field
+  if (size < kPrefixSize || std::memcmp(data, kPrefix, kPrefixSize) != 0) {
+    return std::string_view();
+  }
+  const void* quote = std::memchr(data + kPrefixSize, '"', size - kPrefixSize);
+  if (quote == nullptr) {
+    return std::string_view();
+  }
+  return std::string_view(data + kPrefixSize, static_cast<const char*>(quote) - (data + kPrefixSize));
+}
+
+std::string_view get_coalesce_key(const char* data, size_t size) {
+  std::string_view type = get_response_type(data, size);
+  if (type.empty()) {
+    return std::string_view();
+  }
+
+  // {"@type":"name" is followed by ,"field":value
+  size_t type_end = static_cast<size_t>(type.data() + type.size() - data) + 1;
+  size_t pos = type_end;
+  if (pos >= size || data[pos] != ',' || pos + 1 >= size || data[pos + 1] != '"') {
+    return std::string_view(data, type_end);
+  }
+  const void* name_end = std::memchr(data + pos + 2, '"', size - pos - 2);
+  if (name_end == nullptr) {
+    return std::string_view(data, type_end);
+  }
+  pos = static_cast<size_t>(static_cast<const char*>(name_end) - data) + 1;
+  if (pos >= size || data[pos] != ':') {
+    return std::string_view(data, type_end);
+  }
+  pos++;
+  if (pos >= size || data[pos] == '{' || data[pos] == '[') {
+    return std::string_view(data, type_end);
+  }
+
+  if (data[pos] == '"') {
+    for (pos++; pos < size && data[pos] != '"'; pos++) {
+      if (data[pos] == '\\') {
+        pos++;
+      }
+    }
+    return std::string_view(data, std::min(pos + 1, size));
+  }
+  while (pos < size && data[pos] != ',' && data[pos] != '}') {
+    pos++;
+  }
+  return std::string_view(data, pos);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Per-client subscription filter applied to raw td_receive responses before
+ * any JS string is created.
+ *
+ * Only types starting with "update" are filtered: responses to requests are
+ * always delivered, and so is updateAuthorizationState, which drives client
+ * lifetime. Updates of a coalesced type are collapsed within one receive
+ * engine batch, keeping only the latest value per key (see get_coalesce_key).
+ */
+class UpdateFilter {
+ public:
+  enum class Mode : uint8_t { Allow, Deny };
+
+  UpdateFilter(Mode mode, std::vector<std::string> types, std::vector<std::string> coalesce_types);
+
+  // Whether a response of this @type is delivered
+  bool accepts(std::string_view type) const;
+
+  // Whether updates of this @type may replace an earlier one in the same batch
+  bool coalesces(std::string_view type) const;
+
+  Mode mode() const { return mode_; }
+
+  bool operator==(const UpdateFilter& other) const {
+    return mode_ == other.mode_ && types_ == other.types_ && coalesce_types_ == other.coalesce_types_;
+  }
+
+ private:
+  Mode mode_;
+  // Sorted for binary search with string_view keys
+  std::vector<std::string> types_;
+  std::vector<std::string> coalesce_types_;
+};
+
+/**
+ * Per-@type counters of updates removed by filters. Written by whichever
+ * thread receives updates and read from the JS thread.
+ */
+class UpdateFilterStats {
+ public:
+  struct Counters {
+    uint64_t dropped{0};
+    uint64_t coalesced{0};
+  };
+
+  void add_dropped(std::string_view type);
+  void add_coalesced(std::string_view type);
+
+  std::map<std::string, Counters> snapshot() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, Counters, std::less<>> counters_;
+};
+
+// Returns the leading "@type" of a TDLib response, or an empty view
+std::string_view get_response_type(const char* data, size_t size);
+
+// Returns the prefix of a response identifying what a coalesced update is
+// about: {"@type":"...","first_field":value when the first field after @type
+// is a scalar, otherwise just {"@type":"..."
+std::string_view get_coalesce_key(const char* data, size_t size);
@@ -0,0 +1,112 @@
+/* eslint-disable no-console */
+
+// Compares request submission throughput of the native addon:
+//   send         - one JSON.stringify + addon.send per request (TdlibService.send path)
+//   batch-array  - addon.sendBatch(clientId, string[])
+//   batch-buffer - addon.sendBatch(clientId, Buffer) with newline-delimited JSON
+//
+// Usage: node scripts/benchmark-tdlib-send.js [requests] [rounds]
+// Requires a built addon (npm run build:tdlib-addon) and libtdjson. Paste the
+// printed setup line together with the table when quoting the numbers.
+
+const os = require('os');
+const path = require('path');
+
+const REQUESTS = Number(process.argv[2]) || 20000;
+const ROUNDS = Number(process.argv[3]) || 5;
+
+function loadAddon() {
+  const addonPath =
+    process.env.TDLIB_ADDON_PATH ||
+    path.join(__dirname, '..', 'native', 'tdlib', 'build', 'Release', 'tdlib.node');
+  return require(addonPath);
+}
+
+function makeRequests(count) {
+  const requests = new Array(count);
+  for (let i = 0; i < count; i++) {
+    // getOption is answered in every authorization state
+    requests[i] = { '@type': 'getOption', name: 'version', '@extra': i };
+  }
+  return requests;
+}
+
+// Drop queued responses so one round does not slow down the next
+function drain(addon) {
+  let drained = 0;
+  while (addon.receive(0.2) !== null) {
+    drained++;
+  }
+  return drained;
+}
+
+const modes = {
+  send(addon, clientId, requests) {
+    for (const request of requests) {
+      addon.send(clientId, JSON.stringify(request));
+    }
+  },
+  'batch-array'(addon, clientId, requests) {
+    addon.sendBatch(clientId, requests.map((request) => JSON.stringify(request)));
+  },
+  'batch-buffer'(addon, clientId, requests) {
+    addon.sendBatch(clientId, Buffer.from(requests.map((request) => JSON.stringify(request)).join('\n'), 'utf8'));
+  },
+};
+
+async function main() {
+  const addon = loadAddon();
+  if (typeof addon.sendBatch !== 'function') {
+    console.error('[benchmark] addon has no sendBatch export; rebuild it with npm run build:tdlib-addon');
+    process.exit(1);
+  }
+
+  const clientId = await addon.createClient(() => undefined);
+  const requests = makeRequests(REQUESTS);
+  const cpus = os.cpus();
+  console.log(
+    `[benchmark] node ${process.version}, ${os.platform()}/${os.arch()}, ` +
+      `${cpus.length} x ${cpus.length > 0 ? cpus[0].model : 'unknown CPU'}, ` +
+      `libtdjson ${process.env.TDLIB_LIBRARY_PATH || 'default path'}`,
+  );
+  console.log(`[benchmark] client ${clientId}, ${REQUESTS} requests x ${ROUNDS} rounds`);
+
+  // Warm up the client and the JIT before measuring
+  for (const run of Object.values(modes)) {
+    run(addon, clientId, requests.slice(0, 1000));
+  }
+  drain(addon);
+
+  const results = [];
+  let sendBest = 0;
+  for (const [name, run] of Object.entries(modes)) {
+    let best = Infinity;
+    for (let round = 0; round < ROUNDS; round++) {
+      const start = process.hrtime.bigint();
+      run(addon, clientId, requests);
+      const elapsedNs = Number(process.hrtime.bigint() - start);
+      best = Math.min(best, elapsedNs);
+      drain(addon);
+    }
+    if (name === 'send') {
+      sendBest = best;
+    }
+    results.push({
+      mode: name,
+      'best ms': (best / 1e6).toFixed(2),
+      'requests/s': Math.round((REQUESTS * 1e9) / best),
+      'ns/request': Math.round(best / REQUESTS),
+      'speedup vs send': (sendBest / best).toFixed(2),
+    });
+  }
+
+  console.table(results);
+
+  addon.destroyClient(clientId);
+  drain(addon);
+}
+
+main().catch((error) => {
+  console.error('[benchmark] failed', error);
+  process.exit(1);
+});
@@ -54,11 +54,10 @@ fi
 if command -v nm &> /dev/null; then
     echo -n "Checking for required symbols... "
     REQUIRED_SYMBOLS=(
-        "td_json_client_create"
-        "td_json_client_send"
-        "td_json_client_receive"
-        "td_json_client_execute"
-        "td_json_client_destroy"
+        "td_create_client_id"
+        "td_send"
+        "td_receive"
+        "td_execute"
     )
     
     MISSING_SYMBOLS=0
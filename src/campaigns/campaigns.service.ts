@@ -244,10 +244,10 @@ export class CampaignsService {
       }
 
       // Note: Rate limiting is implemented in CampaignProcessor:
-      // - Per-account rate limiting via delayBetweenMessages calculation
-      // - BullMQ limiter config on telegram queue (max 20 messages/second)
-      // - Staggered message sending with delayBetweenMessages
-      // Additional rate limiting can be configured via campaign.settings.rateLimit
+      // - With the native send pacer, per-account token buckets at settings.rateLimit
+      //   (burst via settings.burst), backing off only the account that gets FLOOD_WAIT
+      // - Otherwise, staggered BullMQ jobs with delayBetweenMessages and the BullMQ
+      //   limiter config on the telegram queue (max 20 messages/second)
 
       // Create job to execute campaign
       await this.jobsService.create(
@@ -1,6 +1,30 @@
 import { Injectable } from '@nestjs/common';
 import { register, collectDefaultMetrics, Gauge, Counter, Histogram } from 'prom-client';
 
+interface NativeLatencySummary {
+  count: number;
+  maxUs: number;
+  p50Us: number;
+  p90Us: number;
+  p99Us: number;
+  p999Us: number;
+}
+
+// Subset of TdlibService.getNativeMetrics() exported to Prometheus
+export interface TdlibNativeMetricsSnapshot {
+  totals: {
+    requestsSent: number;
+    responsesReceived: number;
+    updatesReceived: number;
+    bytesSent: number;
+    bytesReceived: number;
+  };
+  pendingRequests: number;
+  deliveryBacklog: { batches: number; updates: number };
+  responseLatency: NativeLatencySummary;
+  lockWait: Record<string, NativeLatencySummary>;
+}
+
 @Injectable()
 export class MetricsService {
   // API Metrics
@@ -40,6 +64,15 @@ export class MetricsService {
   private readonly tdlibQueueDepth: Gauge<string>;
   private readonly tdlibErrorsTotal: Counter<string>;
 
+  // TDLib native addon metrics, read from the addon on every scrape
+  private readonly tdlibNativeMessagesTotal: Counter<string>;
+  private readonly tdlibNativeBytesTotal: Counter<string>;
+  private readonly tdlibNativePendingRequests: Gauge<string>;
+  private readonly tdlibNativeDeliveryBacklog: Gauge<string>;
+  private readonly tdlibNativeResponseLatency: Gauge<string>;
+  private readonly tdlibNativeLockWait: Gauge<string>;
+  private tdlibNativeMetricsSource: (() => TdlibNativeMetricsSnapshot | null) | null = null;
+
   // Worker Metrics
   private readonly workerJobsProcessedTotal: Counter<string>;
   private readonly workerJobsFailedTotal: Counter<string>;
@@ -210,6 +243,42 @@ export class MetricsService {
       labelNames: ['error_type', 'error_code'],
     });
 
+    this.tdlibNativeMessagesTotal = new Counter({
+      name: 'tdlib_native_messages_total',
+      help: 'Requests sent to and responses/updates received from TDLib by the native addon',
+      labelNames: ['kind'],
+    });
+
+    this.tdlibNativeBytesTotal = new Counter({
+      name: 'tdlib_native_bytes_total',
+      help: 'JSON bytes exchanged with TDLib by the native addon',
+      labelNames: ['direction'],
+    });
+
+    this.tdlibNativePendingRequests = new Gauge({
+      name: 'tdlib_native_pending_requests',
+      help: 'Native invoke() requests awaiting their response',
+      labelNames: [],
+    });
+
+    this.tdlibNativeDeliveryBacklog = new Gauge({
+      name: 'tdlib_native_delivery_backlog',
+      help: 'Receive engine output queued for the JS thread',
+      labelNames: ['unit'],
+    });
+
+    this.tdlibNativeResponseLatency = new Gauge({
+      name: 'tdlib_native_response_latency_seconds',
+      help: 'Native invoke() send-to-response latency quantiles',
+      labelNames: ['quantile'],
+    });
+
+    this.tdlibNativeLockWait = new Gauge({
+      name: 'tdlib_native_lock_wait_seconds',
+      help: 'Native addon mutex wait time quantiles',
+      labelNames: ['lock', 'quantile'],
+    });
+
     // Worker Metrics
     this.workerJobsProcessedTotal = new Counter({
       name: 'worker_jobs_processed_total',
@@ -355,6 +424,43 @@ export class MetricsService {
     this.tdlibQueueDepth.set({ queue }, depth);
   }
 
+  // The source is polled on every scrape; it returns null when the addon has no metrics
+  setTdlibNativeMetricsSource(source: (() => TdlibNativeMetricsSnapshot | null) | null) {
+    this.tdlibNativeMetricsSource = source;
+  }
+
+  setTdlibNativeMetrics(snapshot: TdlibNativeMetricsSnapshot) {
+    const { totals } = snapshot;
+    // Native counters are cumulative, so the exported counters are replaced
+    this.tdlibNativeMessagesTotal.reset();
+    this.tdlibNativeMessagesTotal.inc({ kind: 'request' }, totals.requestsSent);
+    this.tdlibNativeMessagesTotal.inc({ kind: 'response' }, totals.responsesReceived);
+    this.tdlibNativeMessagesTotal.inc({ kind: 'update' }, totals.updatesReceived);
+    this.tdlibNativeBytesTotal.reset();
+    this.tdlibNativeBytesTotal.inc({ direction: 'sent' }, totals.bytesSent);
+    this.tdlibNativeBytesTotal.inc({ direction: 'received' }, totals.bytesReceived);
+
+    this.tdlibNativePendingRequests.set(snapshot.pendingRequests);
+    this.tdlibNativeDeliveryBacklog.set({ unit: 'batches' }, snapshot.deliveryBacklog.batches);
+    this.tdlibNativeDeliveryBacklog.set({ unit: 'updates' }, snapshot.deliveryBacklog.updates);
+
+    this.setLatencyQuantiles(this.tdlibNativeResponseLatency, {}, snapshot.responseLatency);
+    for (const [lock, latency] of Object.entries(snapshot.lockWait)) {
+      this.setLatencyQuantiles(this.tdlibNativeLockWait, { lock }, latency);
+    }
+  }
+
+  private setLatencyQuantiles(gauge: Gauge<string>, labels: Record<string, string>, latency: NativeLatencySummary) {
+    if (latency.count === 0) {
+      return;
+    }
+    gauge.set({ ...labels, quantile: '0.5' }, latency.p50Us / 1e6);
+    gauge.set({ ...labels, quantile: '0.9' }, latency.p90Us / 1e6);
+    gauge.set({ ...labels, quantile: '0.99' }, latency.p99Us / 1e6);
+    gauge.set({ ...labels, quantile: '0.999' }, latency.p999Us / 1e6);
+    gauge.set({ ...labels, quantile: '1' }, latency.maxUs / 1e6);
+  }
+
   incrementTdlibErrors(errorType: string, errorCode?: number) {
     this.tdlibErrorsTotal.inc({
       error_type: errorType,
@@ -385,6 +491,10 @@ export class MetricsService {
 
   // Get metrics for /metrics endpoint
   async getMetrics(): Promise<string> {
+    const nativeMetrics = this.tdlibNativeMetricsSource ? this.tdlibNativeMetricsSource() : null;
+    if (nativeMetrics) {
+      this.setTdlibNativeMetrics(nativeMetrics);
+    }
     return register.metrics();
   }
 
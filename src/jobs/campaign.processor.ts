@@ -19,6 +19,7 @@ export interface CampaignExecuteJobData {
 export class CampaignProcessor implements OnModuleInit {
   private readonly logger = new Logger(CampaignProcessor.name);
   private readonly defaultRateLimit = 20; // messages per second per account
+  private readonly progressUpdateInterval = 1000; // ms between progress updates of paced sends
 
   constructor(
     private readonly queueService: QueueService,
@@ -62,6 +63,13 @@ export class CampaignProcessor implements OnModuleInit {
 
         // Rate limiting per account
         const rateLimit = settings?.rateLimit || this.defaultRateLimit;
+
+        // The native pacer releases messages at the account's rate and backs off
+        // only this account on flood waits; otherwise stagger BullMQ jobs
+        if (this.tdlibService.supportsSendPacing()) {
+          return await this.sendPaced(campaignId, clientId, recipients, template, settings, rateLimit);
+        }
+
         const delayBetweenMessages = Math.ceil(1000 / rateLimit); // ms between messages
 
         let enqueued = 0;
@@ -71,40 +79,14 @@ export class CampaignProcessor implements OnModuleInit {
           const recipient = recipients[i];
           
           try {
-            // Resolve recipient chat ID
-            let chatId: number;
-            if (recipient.chatId) {
-              chatId = typeof recipient.chatId === 'string' 
-                ? parseInt(recipient.chatId, 10) 
-                : recipient.chatId;
-            } else if (recipient.chat_id) {
-              chatId = typeof recipient.chat_id === 'string'
-                ? parseInt(recipient.chat_id, 10)
-                : recipient.chat_id;
-            } else if (recipient.phone || recipient.value) {
-              // Phone number - would need to search contacts first
-              // For now, extract numeric part
-              const phone = recipient.phone || recipient.value;
-              chatId = parseInt(phone.replace(/\D/g, ''), 10);
-            } else {
+            const chatId = this.resolveChatId(recipient);
+            if (chatId === null) {
               this.logger.warn('Invalid recipient format', { recipient, campaignId });
               failed++;
               continue;
             }
 
-            const payload = {
-              '@type': 'sendMessage',
-              chat_id: chatId,
-              input_message_content: {
-                '@type': 'inputMessageText',
-                text: {
-                  '@type': 'formattedText',
-                  text: template?.text ?? '',
-                  entities: template?.entities || [],
-                },
-              },
-              disable_notification: settings?.disableNotification || false,
-            };
+            const payload = this.buildSendMessagePayload(chatId, template, settings);
 
             await this.queueService.addJob(
               TELEGRAM_QUEUE_NAME,
@@ -165,6 +147,98 @@ export class CampaignProcessor implements OnModuleInit {
     );
   }
 
+  /**
+   * Send the campaign through the native send pacer and wait for the outcome
+   * of every message
+   */
+  private async sendPaced(
+    campaignId: string,
+    clientId: string,
+    recipients: Array<any>,
+    template: any,
+    settings: any,
+    rateLimit: number,
+  ): Promise<Record<string, number>> {
+    const payloads: any[] = [];
+    let invalid = 0;
+    for (const recipient of recipients) {
+      const chatId = this.resolveChatId(recipient);
+      if (chatId === null) {
+        this.logger.warn('Invalid recipient format', { recipient, campaignId });
+        invalid++;
+        continue;
+      }
+      payloads.push(this.buildSendMessagePayload(chatId, template, settings));
+    }
+
+    let processed = invalid;
+    let lastProgressUpdate = Date.now();
+    const { batchId, done } = this.tdlibService.sendPaced(clientId, payloads, {
+      pacing: { ratePerSecond: rateLimit, burst: settings?.burst },
+      onResults: (results) => {
+        processed += results.length;
+        const now = Date.now();
+        if (now - lastProgressUpdate >= this.progressUpdateInterval) {
+          lastProgressUpdate = now;
+          void this.updateCampaignProgress(campaignId, processed, recipients.length);
+        }
+      },
+    });
+    this.logger.debug('Campaign messages queued in the send pacer', {
+      campaignId,
+      batchId,
+      count: payloads.length,
+    });
+
+    const summary = await done;
+    await this.updateCampaignProgress(campaignId, processed, recipients.length);
+
+    const result = {
+      sent: summary.sent,
+      failed: invalid + summary.failed,
+      timedOut: summary.timedOut,
+      cancelled: summary.cancelled,
+      total: recipients.length,
+    };
+    this.logger.log('Campaign execution completed', { campaignId, ...result });
+    return result;
+  }
+
+  /**
+   * Resolve the chat ID of a recipient; null if the recipient has none
+   */
+  private resolveChatId(recipient: any): number | null {
+    if (recipient.chatId) {
+      return typeof recipient.chatId === 'string' ? parseInt(recipient.chatId, 10) : recipient.chatId;
+    }
+    if (recipient.chat_id) {
+      return typeof recipient.chat_id === 'string' ? parseInt(recipient.chat_id, 10) : recipient.chat_id;
+    }
+    if (recipient.phone || recipient.value) {
+      // Phone number - would need to search contacts first
+      // For now, extract numeric part
+      const phone = recipient.phone || recipient.value;
+      return parseInt(phone.replace(/\D/g, ''), 10);
+    }
+    return null;
+  }
+
+  private buildSendMessagePayload(chatId: number, template: any, settings: any) {
+    return {
+      '@type': 'sendMessage',
+      chat_id: chatId,
+      input_message_content: {
+        '@type': 'inputMessageText',
+        text: {
+          '@type': 'formattedText',
+          text: template?.text ?? '',
+          entities: template?.entities || [],
+        },
+      },
+      disable_notification: settings?.disableNotification || false,
+    };
+  }
+
   /**
    * Update campaign status
    */
@@ -70,15 +70,18 @@ export class MessageProcessor implements OnModuleInit {
             chatId = parseInt(recipient.replace(/\D/g, ''), 10);
           }
 
-          // Send message via TDLib
-          await this.tdlibService.sendMessage(clientId, chatId, content, {
-            disableNotification: metadata?.options?.disableNotification || false,
-            replyToMessageId: metadata?.options?.replyToMessageId,
-            scheduleDate: metadata?.options?.scheduleDate,
-          });
-
-          // Wait for response
-          const response = await this.waitForMessageResponse(clientId, messageId);
+          // Send message via TDLib and wait until it is sent
+          const response: any = await this.tdlibService.sendMessageAndWait(
+            clientId,
+            chatId,
+            content,
+            {
+              disableNotification: metadata?.options?.disableNotification || false,
+              replyToMessageId: metadata?.options?.replyToMessageId,
+              scheduleDate: metadata?.options?.scheduleDate,
+            },
+            this.responseTimeoutMs,
+          );
 
           if (response && response['@type'] === 'message') {
             // Message sent successfully
@@ -139,51 +142,6 @@ export class MessageProcessor implements OnModuleInit {
     );
   }
 
-  /**
-   * Wait for message response from TDLib
-   */
-  private async waitForMessageResponse(
-    clientId: string,
-    messageId: string,
-  ): Promise<any | null> {
-    const deadline = Date.now() + this.responseTimeoutMs;
-    const pollInterval = 100; // 100ms
-
-    while (Date.now() < deadline) {
-      try {
-        const update = this.tdlibService.receive(clientId, 1.0);
-        if (!update) {
-          await new Promise((resolve) => setTimeout(resolve, pollInterval));
-          continue;
-        }
-
-        // Check if this is a message update for our message
-        if (update['@type'] === 'updateNewMessage') {
-          const message = update.message;
-          // In a real implementation, you'd match by some correlation ID
-          // For now, we'll accept any new message as success
-          return message;
-        }
-
-        // Check for errors
-        if (update['@type'] === 'error') {
-          return update;
-        }
-
-        await new Promise((resolve) => setTimeout(resolve, pollInterval));
-      } catch (error) {
-        this.logger.warn('Error while waiting for message response', {
-          clientId,
-          messageId,
-          error: error instanceof Error ? error.message : String(error),
-        });
-        await new Promise((resolve) => setTimeout(resolve, pollInterval));
-      }
-    }
-
-    return null; // Timeout
-  }
-
   /**
    * Update message status in database
    */
@@ -16,19 +16,11 @@ export interface TelegramJobData {
   recipient?: string;
   messageId?: string;
   payload: any;
-  requestId?: string; // For tracking responses
 }
 
 @Injectable()
 export class TelegramProcessor implements OnModuleInit {
   private readonly logger = new Logger(TelegramProcessor.name);
-  private readonly pendingRequests = new Map<string, {
-    jobId: string;
-    messageId?: string;
-    resolve: (value: any) => void;
-    reject: (error: Error) => void;
-    deadline: number;
-  }>();
 
   constructor(
     private readonly queueService: QueueService,
@@ -38,9 +30,6 @@ export class TelegramProcessor implements OnModuleInit {
   ) {}
 
   async onModuleInit() {
-    // Start polling for updates to match with pending requests
-    this.startUpdatePolling();
-
     this.queueService.createWorker<TelegramJobData>(
       TELEGRAM_QUEUE_NAME,
       async (job: BullMQJob<TelegramJobData>) => {
@@ -65,8 +54,7 @@ export class TelegramProcessor implements OnModuleInit {
    * Process a Telegram job
    */
   private async processTelegramJob(job: BullMQJob<TelegramJobData>): Promise<any> {
-    const { jobId, clientId, payload, messageId, requestId } = job.data;
-    const requestTrackingId = requestId || `req_${jobId}_${Date.now()}`;
+    const { jobId, clientId, payload, messageId } = job.data;
 
     try {
       // Update job status to processing
@@ -77,19 +65,10 @@ export class TelegramProcessor implements OnModuleInit {
         await this.updateMessageStatus(messageId, MessageStatus.SENDING);
       }
 
-      // Add request ID to payload for tracking
-      const payloadWithId = {
-        ...payload,
-        '@extra': requestTrackingId,
-      };
-
-      // Send request to TDLib
-      this.tdlibService.send(clientId, payloadWithId);
-
-      // Wait for response with timeout
-      const response = await this.waitForResponse(
-        requestTrackingId,
+      // Send request to TDLib and wait for its response (null on timeout)
+      const response: any = await this.tdlibService.invoke(
         clientId,
+        payload,
         30000, // 30 second timeout
       );
 
@@ -131,70 +110,6 @@ export class TelegramProcessor implements OnModuleInit {
     }
   }
 
-  /**
-   * Wait for response from TDLib
-   */
-  private async waitForResponse(
-    requestId: string,
-    clientId: string,
-    timeoutMs: number,
-  ): Promise<any> {
-    return new Promise((resolve, reject) => {
-      const deadline = Date.now() + timeoutMs;
-
-      this.pendingRequests.set(requestId, {
-        jobId: '', // Will be set by update handler
-        resolve,
-        reject,
-        deadline,
-      });
-
-      // Set timeout
-      setTimeout(() => {
-        if (this.pendingRequests.has(requestId)) {
-          this.pendingRequests.delete(requestId);
-          resolve(null); // Timeout - return null
-        }
-      }, timeoutMs);
-    });
-  }
-
-  /**
-   * Start polling for updates and matching with pending requests
-   * Note: This complements TdlibUpdatePollingService by handling
-   * request/response matching for job processing
-   */
-  private startUpdatePolling(): void {
-    // Poll for updates every 100ms to match responses with pending requests
-    setInterval(async () => {
-      const clientIds = this.tdlibService.getAllClientIds();
-      
-      for (const clientId of clientIds) {
-        try {
-          const update = this.tdlibService.receive(clientId, 0.1);
-          if (update) {
-            // Check if this update matches a pending request first
-            const requestId = update['@extra'];
-            if (requestId && this.pendingRequests.has(requestId)) {
-              const pending = this.pendingRequests.get(requestId)!;
-              this.pendingRequests.delete(requestId);
-              pending.resolve(update);
-              // Don't dispatch to update handler - this is a direct response
-              continue;
-            }
-
-            // Otherwise, dispatch to update handler (for async updates)
-            // Note: TdlibUpdatePollingService also handles this, but we do it here
-            // to ensure we catch responses even if polling service is disabled
-            await this.updateDispatcher.dispatch(clientId, update);
-          }
-        } catch (error) {
-          // Ignore errors during polling
-        }
-      }
-    }, 100);
-  }
-
   /**
    * Handle success response
    */
@@ -35,85 +35,47 @@ export class TdlibBatchService {
     requests: BatchRequest[],
     timeoutMs = 30000,
   ): Promise<BatchResult[]> {
-    const results: BatchResult[] = [];
-    const deadline = Date.now() + timeoutMs;
-
-    // Send all requests
-    for (const batchReq of requests) {
-      try {
-        this.tdlibService.send(batchReq.clientId, batchReq.request);
-      } catch (error) {
-        results.push({
-          success: false,
-          error: {
-            '@type': 'error',
-            code: 0,
-            message: error instanceof Error ? error.message : String(error),
-          },
-          request: batchReq.request,
-        });
-      }
-    }
-
-    // Collect responses
-    const clientIds = [...new Set(requests.map(r => r.clientId))];
-    const pendingRequests = new Map<string, BatchRequest[]>();
-
-    for (const req of requests) {
-      if (!pendingRequests.has(req.clientId)) {
-        pendingRequests.set(req.clientId, []);
-      }
-      pendingRequests.get(req.clientId)!.push(req);
-    }
-
-    while (Date.now() < deadline && pendingRequests.size > 0) {
-      for (const clientId of clientIds) {
-        const response = this.tdlibService.receive(clientId, 0.1);
-        if (response) {
-          const pending = pendingRequests.get(clientId);
-          if (pending && pending.length > 0) {
-            const req = pending.shift()!;
-            if (response['@type'] === 'error') {
-              results.push({
-                success: false,
-                error: response as TdlibError,
-                request: req.request,
-              });
-            } else {
-              results.push({
-                success: true,
-                response: response,
-                request: req.request,
-              });
-            }
+    // Responses are matched to their requests by invoke(), in any order
+    return Promise.all(
+      requests.map(async (batchReq): Promise<BatchResult> => {
+        try {
+          const response = await this.tdlibService.invoke(batchReq.clientId, batchReq.request, timeoutMs);
+          if (!response) {
+            return {
+              success: false,
+              error: {
+                '@type': 'error',
+                code: 408,
+                message: 'Request timeout',
+              },
+              request: batchReq.request,
+            };
           }
+          if (response['@type'] === 'error') {
+            return {
+              success: false,
+              error: response as TdlibError,
+              request: batchReq.request,
+            };
+          }
+          return {
+            success: true,
+            response: response,
+            request: batchReq.request,
+          };
+        } catch (error) {
+          return {
+            success: false,
+            error: {
+              '@type': 'error',
+              code: 0,
+              message: error instanceof Error ? error.message : String(error),
+            },
+            request: batchReq.request,
+          };
         }
-      }
-
-      // Remove completed clients
-      for (const [clientId, pending] of pendingRequests.entries()) {
-        if (pending.length === 0) {
-          pendingRequests.delete(clientId);
-        }
-      }
-    }
-
-    // Mark remaining as timeout
-    for (const [clientId, pending] of pendingRequests.entries()) {
-      for (const req of pending) {
-        results.push({
-          success: false,
-          error: {
-            '@type': 'error',
-            code: 408,
-            message: 'Request timeout',
-          },
-          request: req.request,
-        });
-      }
-    }
-
-    return results;
+      }),
+    );
   }
 
   /**
@@ -8,7 +8,7 @@ import { Injectable } from '@nestjs/common';
 import { TdlibService } from '../tdlib.service';
 import { CustomLoggerService } from '../../common/services/logger.service';
 import { TdlibClientNotFoundException } from '../exceptions/tdlib.exceptions';
-import { TdlibRequest, TdlibResponse, TdlibError } from '../types';
+import { TdlibRequest, TdlibResponse } from '../types';
 
 @Injectable()
 export class TdlibChannelService {
@@ -37,23 +37,7 @@ export class TdlibChannelService {
       is_forum: isForum,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for createChannel response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -72,23 +56,7 @@ export class TdlibChannelService {
       chat_id: typeof channelId === 'string' ? parseInt(channelId, 10) : channelId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannel response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -107,23 +75,7 @@ export class TdlibChannelService {
       chat_id: typeof channelId === 'string' ? parseInt(channelId, 10) : channelId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatFullInfo') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelFullInfo response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatFullInfo', 10000);
   }
 
   /**
@@ -149,23 +101,7 @@ export class TdlibChannelService {
       (request as Record<string, unknown>).description = description;
     }
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editChannel response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -186,23 +122,7 @@ export class TdlibChannelService {
       description: about,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editChannelAbout response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -223,23 +143,7 @@ export class TdlibChannelService {
       sign_messages: signMessages,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for toggleChannelSignMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -260,23 +164,7 @@ export class TdlibChannelService {
       is_all_history_available: isAllHistoryAvailable,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for toggleChannelIsAllHistoryAvailable response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -295,23 +183,7 @@ export class TdlibChannelService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for upgradeGroupChatToSupergroupChat response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -336,23 +208,7 @@ export class TdlibChannelService {
       limit: limit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatMembers') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelMembers response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatMembers', 10000);
   }
 
   /**
@@ -394,23 +250,7 @@ export class TdlibChannelService {
       },
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatMember') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelMember response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatMember', 10000);
   }
 
   /**
@@ -457,23 +297,7 @@ export class TdlibChannelService {
       status: status,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChannelMemberStatus response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -501,23 +325,7 @@ export class TdlibChannelService {
       revoke_messages: revokeMessages,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for banChannelMember response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -532,23 +340,7 @@ export class TdlibChannelService {
       '@type': 'canTransferOwnership',
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'canTransferOwnershipResult') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for canTransferOwnership response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'canTransferOwnershipResult', 10000);
   }
 
   /**
@@ -571,23 +363,7 @@ export class TdlibChannelService {
       password: password,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for transferChannelOwnership response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -608,23 +384,7 @@ export class TdlibChannelService {
       is_dark: isDark,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatStatistics') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelStatistics response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatStatistics', 10000);
   }
 
   /**
@@ -647,23 +407,7 @@ export class TdlibChannelService {
       is_dark: isDark,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageStatistics') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelMessageStatistics response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messageStatistics', 10000);
   }
 
   /**
@@ -686,23 +430,7 @@ export class TdlibChannelService {
       message_ids: messageIds,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for reportChannel response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -721,23 +449,7 @@ export class TdlibChannelService {
       chat_id: typeof channelId === 'string' ? parseInt(channelId, 10) : channelId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'availableReactions') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelAvailableReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'availableReactions', 10000);
   }
 
   /**
@@ -758,23 +470,7 @@ export class TdlibChannelService {
       available_reactions: availableReactions,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChannelAvailableReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -795,23 +491,7 @@ export class TdlibChannelService {
       sticker_set_id: stickerSetId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChannelStickerSet response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -832,23 +512,7 @@ export class TdlibChannelService {
       is_broadcast_group: isBroadcastGroup,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for toggleChannelIsBroadcastGroup response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -867,23 +531,7 @@ export class TdlibChannelService {
       chat_id: typeof channelId === 'string' ? parseInt(channelId, 10) : channelId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chats') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChannelRecommendations response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chats', 10000);
   }
 
   /**
@@ -904,22 +552,6 @@ export class TdlibChannelService {
       opened_chat_id: typeof openedChatId === 'string' ? parseInt(openedChatId, 10) : openedChatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for viewChannelRecommendation response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 }
@@ -8,7 +8,7 @@ import { Injectable } from '@nestjs/common';
 import { TdlibService } from '../tdlib.service';
 import { CustomLoggerService } from '../../common/services/logger.service';
 import { TdlibClientNotFoundException } from '../exceptions/tdlib.exceptions';
-import { TdlibRequest, TdlibResponse, TdlibError } from '../types';
+import { TdlibRequest, TdlibResponse } from '../types';
 
 @Injectable()
 export class TdlibChatService {
@@ -35,23 +35,7 @@ export class TdlibChatService {
       force: force,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for createPrivateChat response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -73,23 +57,7 @@ export class TdlibChatService {
     } as TdlibRequest;
 
     // Note: This is a simplified version. In practice, you'd need to create the basic group first
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for createGroupChat response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -110,23 +78,7 @@ export class TdlibChatService {
       force: force,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for createSupergroupChat response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -145,23 +97,7 @@ export class TdlibChatService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chat') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChat response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chat', 10000);
   }
 
   /**
@@ -188,23 +124,7 @@ export class TdlibChatService {
       only_local: onlyLocal,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // Longer timeout for history
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatHistory response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 30000); // Longer timeout for history
   }
 
   /**
@@ -235,23 +155,7 @@ export class TdlibChatService {
       filter: filter,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for searchChatMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 30000);
   }
 
   /**
@@ -275,23 +179,7 @@ export class TdlibChatService {
       },
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatMember') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatMember response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatMember', 10000);
   }
 
   /**
@@ -316,23 +204,7 @@ export class TdlibChatService {
       limit: limit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatMembers') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatMembers response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatMembers', 30000);
   }
 
   /**
@@ -364,23 +236,7 @@ export class TdlibChatService {
       title: title,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editChatTitle response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -401,23 +257,7 @@ export class TdlibChatService {
       description: description,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editChatDescription response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -438,23 +278,7 @@ export class TdlibChatService {
       photo: photo,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editChatPhoto response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -477,23 +301,7 @@ export class TdlibChatService {
       background_gradient_id: backgroundGradientId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChatAccentColors response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -514,23 +322,7 @@ export class TdlibChatService {
       profile_accent_color_id: profileAccentColorId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChatProfileAccentColor response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -551,23 +343,7 @@ export class TdlibChatService {
       permissions: permissions,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChatPermissions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -588,23 +364,7 @@ export class TdlibChatService {
       slow_mode_delay: slowModeDelay,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChatSlowModeDelay response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -629,23 +389,7 @@ export class TdlibChatService {
       only_for_self: onlyForSelf,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for pinChatMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -666,23 +410,7 @@ export class TdlibChatService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for unpinChatMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -701,23 +429,7 @@ export class TdlibChatService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for unpinAllChatMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -740,23 +452,7 @@ export class TdlibChatService {
       forward_limit: forwardLimit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for addChatMember response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -777,23 +473,7 @@ export class TdlibChatService {
       user_ids: userIds.map(id => typeof id === 'string' ? parseInt(id, 10) : id),
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for addChatMembers response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -819,23 +499,7 @@ export class TdlibChatService {
       status: status,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setChatMemberStatus response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -863,23 +527,7 @@ export class TdlibChatService {
       revoke_messages: revokeMessages,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for banChatMember response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -894,23 +542,7 @@ export class TdlibChatService {
       '@type': 'canTransferOwnership',
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'canTransferOwnershipResult') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for canTransferOwnership response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'canTransferOwnershipResult', 10000);
   }
 
   /**
@@ -933,23 +565,7 @@ export class TdlibChatService {
       password: password,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for transferChatOwnership response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -970,23 +586,7 @@ export class TdlibChatService {
       is_dark: isDark,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatStatistics') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatStatistics response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatStatistics', 10000);
   }
 
   /**
@@ -1009,23 +609,7 @@ export class TdlibChatService {
       is_dark: isDark,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageStatistics') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatMessageStatistics response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messageStatistics', 10000);
   }
 
   /**
@@ -1046,23 +630,7 @@ export class TdlibChatService {
       date: date,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'message') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatMessageByDate response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'message', 10000);
   }
 
   /**
@@ -1081,22 +649,6 @@ export class TdlibChatService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getChatScheduledMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 10000);
   }
 }
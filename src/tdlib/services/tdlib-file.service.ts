@@ -8,7 +8,7 @@ import { Injectable } from '@nestjs/common';
 import { TdlibService } from '../tdlib.service';
 import { CustomLoggerService } from '../../common/services/logger.service';
 import { TdlibClientNotFoundException } from '../exceptions/tdlib.exceptions';
-import { TdlibRequest, TdlibResponse, TdlibError } from '../types';
+import { TdlibRequest, TdlibResponse } from '../types';
 
 @Injectable()
 export class TdlibFileService {
@@ -41,23 +41,7 @@ export class TdlibFileService {
       synchronous: synchronous,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // 30 second timeout for downloads
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'file') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for downloadFile response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'file', 30000); // 30 second timeout for downloads
   }
 
   /**
@@ -80,23 +64,7 @@ export class TdlibFileService {
       priority: priority,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // 30 second timeout for uploads
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'file') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for uploadFile response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'file', 30000); // 30 second timeout for uploads
   }
 
   /**
@@ -115,23 +83,7 @@ export class TdlibFileService {
       file_id: fileId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'file') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getFile response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'file', 10000);
   }
 
   /**
@@ -152,23 +104,7 @@ export class TdlibFileService {
       only_if_pending: onlyIfPending,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 5000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for cancelDownloadFile response');
+    await this.tdlibService.invokeExpecting(clientId, request, 'ok', 5000);
   }
 
   /**
@@ -189,22 +125,6 @@ export class TdlibFileService {
       file_type: fileType,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'file') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getRemoteFile response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'file', 10000);
   }
 }
@@ -8,7 +8,7 @@ import { Injectable } from '@nestjs/common';
 import { TdlibService } from '../tdlib.service';
 import { CustomLoggerService } from '../../common/services/logger.service';
 import { TdlibClientNotFoundException } from '../exceptions/tdlib.exceptions';
-import { TdlibRequest, TdlibResponse, TdlibError } from '../types';
+import { TdlibRequest, TdlibResponse } from '../types';
 
 export interface SendMessageOptions {
   replyToMessageId?: number;
@@ -46,24 +46,7 @@ export class TdlibMessageService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    // Wait for response
-    const deadline = Date.now() + 10000; // 10 second timeout
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'message') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'message', 10000); // 10 second timeout
   }
 
   /**
@@ -84,28 +67,9 @@ export class TdlibMessageService {
       message_ids: messageIds,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const messages: TdlibResponse[] = [];
-    const deadline = Date.now() + 10000;
-
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          const messagesResponse = response as Record<string, unknown>;
-          const msgs = (messagesResponse.messages as unknown[]) || [];
-          messages.push(...msgs.map(msg => msg as TdlibResponse));
-          break;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    return messages;
+    const response = await this.tdlibService.invokeExpecting(clientId, request, 'messages', 10000);
+    const msgs = ((response as Record<string, unknown>).messages as unknown[]) || [];
+    return msgs.map(msg => msg as TdlibResponse);
   }
 
   /**
@@ -136,23 +100,7 @@ export class TdlibMessageService {
       },
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'message') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for editMessageText response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'message', 10000);
   }
 
   /**
@@ -175,23 +123,7 @@ export class TdlibMessageService {
       revoke: revoke,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for deleteMessages response');
+    await this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -217,23 +149,7 @@ export class TdlibMessageService {
       from_background: options.fromBackground || false,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for forwardMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 10000);
   }
 
   /**
@@ -257,23 +173,7 @@ export class TdlibMessageService {
       reply_to_message_id: options.replyToMessageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // 30 second timeout for albums
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for sendMessageAlbum response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 30000); // 30 second timeout for albums
   }
 
   /**
@@ -294,23 +194,7 @@ export class TdlibMessageService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageThread response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messages', 10000);
   }
 
   /**
@@ -337,24 +221,8 @@ export class TdlibMessageService {
       in_message_thread: inMessageThread,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageLink') {
-          const linkResponse = response as Record<string, unknown>;
-          return (linkResponse.link as string) || '';
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageLink response');
+    const response = await this.tdlibService.invokeExpecting(clientId, request, 'messageLink', 10000);
+    return ((response as Record<string, unknown>).link as string) || '';
   }
 
   /**
@@ -375,23 +243,9 @@ export class TdlibMessageService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 5000; // Shorter timeout for local
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 0.5);
-      if (response) {
-        if (response['@type'] === 'message') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          // For local, errors might mean not in cache
-          return null;
-        }
-      }
-    }
-
-    return null;
+    const response = await this.tdlibService.invoke(clientId, request, 5000); // Shorter timeout for local
+    // For local, errors might mean not in cache
+    return response && response['@type'] === 'message' ? response : null;
   }
 
   /**
@@ -416,23 +270,7 @@ export class TdlibMessageService {
       only_for_self: onlyForSelf,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for pinMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -453,23 +291,7 @@ export class TdlibMessageService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for unpinMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -488,23 +310,7 @@ export class TdlibMessageService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for unpinAllMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -525,23 +331,7 @@ export class TdlibMessageService {
       message_ids: messageIds,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for readMessageContents response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -560,23 +350,7 @@ export class TdlibMessageService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for readAllMessageMentions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -595,23 +369,7 @@ export class TdlibMessageService {
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for readAllMessageReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -634,23 +392,7 @@ export class TdlibMessageService {
       is_dark: isDark,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageStatistics') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageStatistics response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messageStatistics', 10000);
   }
 
   /**
@@ -675,23 +417,7 @@ export class TdlibMessageService {
       limit: limit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'publicForwards') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessagePublicForwards response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'publicForwards', 10000);
   }
 
   /**
@@ -714,23 +440,7 @@ export class TdlibMessageService {
       reason: reason,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for reportMessage response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -751,23 +461,7 @@ export class TdlibMessageService {
       message_id: messageId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageReadDate') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageReadDate response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messageReadDate', 10000);
   }
 
   /**
@@ -794,23 +488,7 @@ export class TdlibMessageService {
       limit: limit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'addedReactions') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageAddedReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'addedReactions', 10000);
   }
 
   /**
@@ -837,23 +515,7 @@ export class TdlibMessageService {
       update_recent_reactions: updateRecentReactions,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for addMessageReaction response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -876,23 +538,7 @@ export class TdlibMessageService {
       reaction_type: reactionType,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for removeMessageReaction response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -917,23 +563,7 @@ export class TdlibMessageService {
       is_big: isBig,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setMessageReaction response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -956,23 +586,7 @@ export class TdlibMessageService {
       row_size: rowSize,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'availableReactions') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageAvailableReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'availableReactions', 10000);
   }
 
   /**
@@ -1005,23 +619,7 @@ export class TdlibMessageService {
       max_date: maxDate,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // Longer timeout for search
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'foundMessages') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for searchMessages response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'foundMessages', 30000); // Longer timeout for search
   }
 
   /**
@@ -1044,24 +642,8 @@ export class TdlibMessageService {
       for_album: forAlbum,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'text') {
-          const textResponse = response as Record<string, unknown>;
-          return (textResponse.text as string) || '';
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageEmbeddingCode response');
+    const response = await this.tdlibService.invokeExpecting(clientId, request, 'text', 10000);
+    return ((response as Record<string, unknown>).text as string) || '';
   }
 
   /**
@@ -1080,23 +662,7 @@ export class TdlibMessageService {
       url: url,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'messageLinkInfo') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getMessageLinkInfo response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'messageLinkInfo', 10000);
   }
 
   /**
@@ -1119,23 +685,7 @@ export class TdlibMessageService {
       to_language_code: toLanguageCode,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 30000; // Longer timeout for translation
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'formattedText') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for translateMessageText response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'formattedText', 30000); // Longer timeout for translation
   }
 
   /**
@@ -1158,22 +708,6 @@ export class TdlibMessageService {
       sender_id: senderId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for reportMessageReactions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 }
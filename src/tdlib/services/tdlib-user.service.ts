@@ -8,7 +8,7 @@ import { Injectable } from '@nestjs/common';
 import { TdlibService } from '../tdlib.service';
 import { CustomLoggerService } from '../../common/services/logger.service';
 import { TdlibClientNotFoundException } from '../exceptions/tdlib.exceptions';
-import { TdlibRequest, TdlibResponse, TdlibError } from '../types';
+import { TdlibRequest, TdlibResponse } from '../types';
 
 @Injectable()
 export class TdlibUserService {
@@ -33,23 +33,7 @@ export class TdlibUserService {
       user_id: typeof userId === 'string' ? parseInt(userId, 10) : userId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'user') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getUser response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'user', 10000);
   }
 
   /**
@@ -68,23 +52,7 @@ export class TdlibUserService {
       user_id: typeof userId === 'string' ? parseInt(userId, 10) : userId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'userFullInfo') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getUserFullInfo response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'userFullInfo', 10000);
   }
 
   /**
@@ -107,23 +75,7 @@ export class TdlibUserService {
       limit: limit,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'chatPhotos') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getUserProfilePhotos response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'chatPhotos', 10000);
   }
 
   /**
@@ -143,23 +95,7 @@ export class TdlibUserService {
       photo: photo,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setUserPersonalProfilePhoto response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -180,23 +116,7 @@ export class TdlibUserService {
       photo: photo,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setUserProfilePhoto response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -217,23 +137,7 @@ export class TdlibUserService {
       photo_id: photoId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for deleteUserProfilePhoto response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -252,23 +156,7 @@ export class TdlibUserService {
       username: username,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setUsername response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -287,23 +175,7 @@ export class TdlibUserService {
       bio: bio,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setBio response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -326,23 +198,7 @@ export class TdlibUserService {
       commands: commands,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setCommands response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -363,23 +219,7 @@ export class TdlibUserService {
       language_code: languageCode,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'botCommands') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getCommands response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'botCommands', 10000);
   }
 
   /**
@@ -400,23 +240,7 @@ export class TdlibUserService {
       language_code: languageCode,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for deleteCommands response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -439,23 +263,7 @@ export class TdlibUserService {
       commands: commands,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setCommandsScope response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -470,23 +278,7 @@ export class TdlibUserService {
       '@type': 'getActiveSessions',
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'sessions') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getActiveSessions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'sessions', 10000);
   }
 
   /**
@@ -505,23 +297,7 @@ export class TdlibUserService {
       session_id: sessionId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for terminateSession response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -536,23 +312,7 @@ export class TdlibUserService {
       '@type': 'terminateAllOtherSessions',
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for terminateAllOtherSessions response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -573,23 +333,7 @@ export class TdlibUserService {
       can_accept_calls: canAcceptCalls,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for toggleSessionCanAcceptCalls response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -610,23 +354,7 @@ export class TdlibUserService {
       can_accept_secret_chats: canAcceptSecretChats,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for toggleSessionCanAcceptSecretChats response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -645,23 +373,7 @@ export class TdlibUserService {
       inactive_session_ttl_days: inactiveSessionTtlDays,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for setInactiveSessionTtl response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 
   /**
@@ -676,23 +388,7 @@ export class TdlibUserService {
       '@type': 'getConnectedWebsites',
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'connectedWebsites') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for getConnectedWebsites response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'connectedWebsites', 10000);
   }
 
   /**
@@ -711,22 +407,6 @@ export class TdlibUserService {
       website_id: websiteId,
     } as TdlibRequest;
 
-    this.tdlibService.send(clientId, request);
-
-    const deadline = Date.now() + 10000;
-    while (Date.now() < deadline) {
-      const response = this.tdlibService.receive(clientId, 1.0);
-      if (response) {
-        if (response['@type'] === 'ok') {
-          return response;
-        }
-        if (response['@type'] === 'error') {
-          const error = response as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
-    }
-
-    throw new Error('Timeout waiting for disconnectWebsite response');
+    return this.tdlibService.invokeExpecting(clientId, request, 'ok', 10000);
   }
 }
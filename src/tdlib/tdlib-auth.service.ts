@@ -4,6 +4,7 @@ import { RedisService } from '../config/redis.service';
 import { TdlibService } from './tdlib.service';
 import { TdlibSessionStore, TdlibSession } from './tdlib-session.store';
 import { CustomLoggerService } from '../common/services/logger.service';
+import { TdlibError } from './types';
 import {
   TdlibNotReadyException,
   TdlibClientNotFoundException,
@@ -326,82 +327,68 @@ export class TdlibAuthService {
   }
 
   /**
-   * Poll TDLib for authorizationState updates until one of the expected states
-   * is reached or timeout occurs.
+   * Wait for authorizationState updates until one of the expected states
+   * is reached or timeout occurs. Must be called right after the request is
+   * sent, before yielding to the event loop, so no update is missed.
    */
   private async waitForAuthorizationState(
     clientId: string,
     expectedStates: string[],
   ): Promise<string | null> {
-    const deadline = Date.now() + this.authWaitTimeoutMs;
-    const pollInterval = 100; // 100ms between polls
-
-    while (Date.now() < deadline) {
-      try {
-        const update = this.tdlibService.receive(clientId, 1.0);
-        if (!update) {
-          await new Promise((resolve) => setTimeout(resolve, pollInterval));
-          continue;
-        }
-
+    const update = await this.tdlibService.waitForUpdate(
+      clientId,
+      (candidate) => {
         // Handle updateAuthorizationState
-        if (update['@type'] === 'updateAuthorizationState') {
-          const authState = update.authorization_state;
+        if (candidate['@type'] === 'updateAuthorizationState') {
+          const authState = (candidate as Record<string, any>).authorization_state;
           const stateType = authState?.['@type'] as string | undefined;
-          
-          if (stateType) {
-            this.logger.debug('Authorization state update', {
-              clientId,
-              state: stateType,
-              expectedStates,
-            });
-
-            if (expectedStates.includes(stateType)) {
-              return stateType;
-            }
-
-            // Handle error states
-            if (stateType === 'authorizationStateClosed') {
-              throw new Error('AUTHORIZATION_CLOSED');
-            }
+          if (!stateType) {
+            return false;
           }
+
+          this.logger.debug('Authorization state update', {
+            clientId,
+            state: stateType,
+            expectedStates,
+          });
+          return expectedStates.includes(stateType) || stateType === 'authorizationStateClosed';
         }
 
         // Handle other relevant updates
-        if (update['@type'] === 'error') {
-          const errorCode = update.code;
-          const errorMessage = update.message || 'Unknown error';
+        if (candidate['@type'] === 'error') {
+          const error = candidate as TdlibError;
           this.logger.warn('TDLib error during auth', {
             clientId,
-            errorCode,
-            errorMessage,
+            errorCode: error.code,
+            errorMessage: error.message || 'Unknown error',
           });
-          
+
           // Some errors are recoverable, others are not
-          if (errorCode === 400 || errorCode === 401) {
-            throw new Error(`AUTH_ERROR_${errorCode}: ${errorMessage}`);
-          }
+          return error.code === 400 || error.code === 401;
         }
+        return false;
+      },
+      this.authWaitTimeoutMs,
+    );
 
-        await new Promise((resolve) => setTimeout(resolve, pollInterval));
-      } catch (error) {
-        if (error instanceof Error && error.message.includes('AUTH_ERROR')) {
-          throw error;
-        }
-        // Log but continue polling for other errors
-        this.logger.warn('Error while waiting for auth state', {
-          clientId,
-          error: error instanceof Error ? error.message : String(error),
-        });
-        await new Promise((resolve) => setTimeout(resolve, pollInterval));
-      }
+    if (!update) {
+      this.logger.warn('Timeout waiting for authorization state', {
+        clientId,
+        expectedStates,
+      });
+      return null;
     }
 
-    this.logger.warn('Timeout waiting for authorization state', {
-      clientId,
-      expectedStates,
-    });
-    return null;
+    if (update['@type'] === 'error') {
+      const error = update as TdlibError;
+      throw new Error(`AUTH_ERROR_${error.code}: ${error.message || 'Unknown error'}`);
+    }
+
+    const stateType = (update as Record<string, any>).authorization_state['@type'] as string;
+    if (stateType === 'authorizationStateClosed') {
+      throw new Error('AUTHORIZATION_CLOSED');
+    }
+    return stateType;
   }
 
   /**
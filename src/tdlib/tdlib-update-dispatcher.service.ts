@@ -5,6 +5,36 @@ import { TdlibMessageUpdateHandler } from './handlers/tdlib-message-update.handl
 import { TdlibAccountUpdateHandler } from './handlers/tdlib-account-update.handler';
 import { TdlibChatUpdateHandler } from './handlers/tdlib-chat-update.handler';
 
+/**
+ * Update types routed to a handler by TdlibUpdateDispatcher.dispatch(). All
+ * other updates are ignored, so the addon may drop them before they reach JS.
+ * Status and read-state updates such as updateUserStatus and
+ * updateChatReadInbox have handlers, so they are coalesced per user or chat
+ * instead (TDLIB_UPDATE_COALESCE_TYPES) and only the latest one is delivered.
+ */
+export const DISPATCHED_UPDATE_TYPES: readonly string[] = [
+  'updateNewMessage',
+  'updateMessageSendSucceeded',
+  'updateMessageSendFailed',
+  'updateMessageContent',
+  'updateMessageEdited',
+  'updateMessageIsPinned',
+  'updateDeleteMessages',
+  'updateAuthorizationState',
+  'updateUser',
+  'updateUserStatus',
+  'updateUserFullInfo',
+  'updateNewChat',
+  'updateChatTitle',
+  'updateChatPhoto',
+  'updateChatLastMessage',
+  'updateChatReadInbox',
+  'updateChatReadOutbox',
+  'updateChatUnreadMentionCount',
+  'updateChatUnreadReactionCount',
+  'updateConnectionState',
+];
+
 /**
  * Service that dispatches TDLib updates to appropriate handlers
  */
@@ -3,11 +3,12 @@ import { ConfigService } from '@nestjs/config';
 import { TdlibService } from './tdlib.service';
 import { TdlibSessionStore } from './tdlib-session.store';
 import { CustomLoggerService } from '../common/services/logger.service';
-import { TdlibUpdateDispatcher } from './tdlib-update-dispatcher.service';
+import { DISPATCHED_UPDATE_TYPES, TdlibUpdateDispatcher } from './tdlib-update-dispatcher.service';
 
 /**
- * Service that polls TDLib for updates from all active clients
- * and dispatches them to appropriate handlers
+ * Service that delivers TDLib updates from all active clients to the
+ * appropriate handlers. Updates are pushed by the native receive engine when
+ * the addon supports it; otherwise every session is polled on an interval.
  */
 @Injectable()
 export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy {
@@ -16,6 +17,13 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
   private isPolling = false;
   private readonly pollIntervalMs: number;
   private readonly pollTimeoutSeconds: number;
+  private readonly receiveEngineEnabled: boolean;
+  private readonly receiveBatchSize: number;
+  private readonly receiveFlushIntervalMs: number;
+  private readonly updateFilterEnabled: boolean;
+  private readonly coalescedUpdateTypes: string[];
+  private mode: 'push' | 'poll' | null = null;
+  private unsubscribe: (() => void) | null = null;
 
   constructor(
     private readonly configService: ConfigService,
@@ -26,6 +34,19 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
   ) {
     this.pollIntervalMs = this.configService.get<number>('TDLIB_POLL_INTERVAL_MS', 100) || 100;
     this.pollTimeoutSeconds = this.configService.get<number>('TDLIB_POLL_TIMEOUT_SECONDS', 1.0) || 1.0;
+    this.receiveEngineEnabled = String(this.configService.get('TDLIB_RECEIVE_ENGINE_ENABLED', true)) !== 'false';
+    this.receiveBatchSize = this.configService.get<number>('TDLIB_RECEIVE_BATCH_SIZE', 256) || 256;
+    this.receiveFlushIntervalMs = this.configService.get<number>('TDLIB_RECEIVE_FLUSH_INTERVAL_MS', 5) || 5;
+    this.updateFilterEnabled = this.configService.get<boolean>('TDLIB_UPDATE_FILTER_ENABLED', true) !== false;
+    this.coalescedUpdateTypes = (
+      this.configService.get<string>(
+        'TDLIB_UPDATE_COALESCE_TYPES',
+        'updateUserStatus,updateChatReadInbox,updateChatReadOutbox,updateChatUnreadMentionCount,updateChatUnreadReactionCount,updateConnectionState',
+      ) || ''
+    )
+      .split(',')
+      .map((type) => type.trim())
+      .filter((type) => type.length > 0);
   }
 
   async onModuleInit() {
@@ -48,7 +69,7 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
   }
 
   /**
-   * Start polling for updates
+   * Start delivering updates, preferring the native receive engine
    */
   startPolling(): void {
     if (this.isPolling) {
@@ -57,6 +78,47 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
     }
 
     this.isPolling = true;
+
+    // Updates the dispatcher would ignore are dropped in the addon
+    if (
+      this.updateFilterEnabled &&
+      this.tdlibService.setDefaultUpdateFilter({
+        mode: 'allow',
+        types: [...DISPATCHED_UPDATE_TYPES],
+        coalesce: this.coalescedUpdateTypes,
+      })
+    ) {
+      this.logger.log('Native TDLib update filter enabled', {
+        types: DISPATCHED_UPDATE_TYPES.length,
+        coalesce: this.coalescedUpdateTypes,
+      });
+    }
+
+    this.unsubscribe = this.tdlibService.addUpdateListener((clientId, update) => {
+      this.updateDispatcher.dispatch(clientId, update).catch((error) => {
+        this.logger.error('Error dispatching update', {
+          clientId,
+          error: error instanceof Error ? error.message : String(error),
+        });
+      });
+    });
+
+    if (
+      this.receiveEngineEnabled &&
+      this.tdlibService.startUpdateStream({
+        maxBatchSize: this.receiveBatchSize,
+        flushIntervalMs: this.receiveFlushIntervalMs,
+      })
+    ) {
+      this.mode = 'push';
+      this.logger.log('Receiving TDLib updates from native receive engine', {
+        maxBatchSize: this.receiveBatchSize,
+        flushIntervalMs: this.receiveFlushIntervalMs,
+      });
+      return;
+    }
+
+    this.mode = 'poll';
     this.logger.log('Starting TDLib update polling', {
       intervalMs: this.pollIntervalMs,
       timeoutSeconds: this.pollTimeoutSeconds,
@@ -85,6 +147,17 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
       clearInterval(this.pollingInterval);
       this.pollingInterval = null;
     }
+    if (this.mode === 'push') {
+      this.tdlibService.stopUpdateStream();
+    }
+    if (this.unsubscribe) {
+      this.unsubscribe();
+      this.unsubscribe = null;
+    }
+    if (this.updateFilterEnabled) {
+      this.tdlibService.setDefaultUpdateFilter(null);
+    }
+    this.mode = null;
 
     this.logger.log('TDLib update polling stopped');
   }
@@ -124,15 +197,8 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
    */
   private async pollClientUpdates(clientId: string): Promise<void> {
     try {
-      // Receive updates with timeout
-      const update = this.tdlibService.receive(clientId, this.pollTimeoutSeconds);
-      
-      if (!update) {
-        return; // No update available
-      }
-
-      // Dispatch update to handlers
-      await this.updateDispatcher.dispatch(clientId, update);
+      // Receive an update with timeout; listeners dispatch it to handlers
+      this.tdlibService.pollUpdates(clientId, this.pollTimeoutSeconds);
     } catch (error) {
       // Log but don't throw - continue polling other clients
       this.logger.debug('Error receiving update from client', {
@@ -145,9 +211,15 @@ export class TdlibUpdatePollingService implements OnModuleInit, OnModuleDestroy
   /**
    * Get polling status
    */
-  getStatus(): { isPolling: boolean; intervalMs: number; timeoutSeconds: number } {
+  getStatus(): {
+    isPolling: boolean;
+    mode: 'push' | 'poll' | null;
+    intervalMs: number;
+    timeoutSeconds: number;
+  } {
     return {
       isPolling: this.isPolling,
+      mode: this.mode,
       intervalMs: this.pollIntervalMs,
       timeoutSeconds: this.pollTimeoutSeconds,
     };
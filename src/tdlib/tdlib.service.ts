@@ -2,6 +2,7 @@ import { Injectable, OnModuleDestroy, OnModuleInit, Inject } from '@nestjs/commo
 import { ConfigService } from '@nestjs/config';
 import { CustomLoggerService } from '../common/services/logger.service';
 import { MetricsService } from '../common/services/metrics.service';
+import * as fs from 'fs';
 import * as path from 'path';
 import {
   TdlibNotReadyException,
@@ -15,10 +16,13 @@ import { TdlibRequestValidator, TdlibResponseValidator } from './validation';
 import { TdlibRateLimiterService } from './services/tdlib-rate-limiter.service';
 
 // Thin abstraction over the native addon. Provides basic wrappers
-// around td_json_client_* for higher-level services.
+// around td_create_client_id / td_send / td_receive for higher-level services.
 
 interface TdlibClientHandle {
+  // String form of the native client identifier, used as the session key
   id: string;
+  // Integer identifier assigned by TDLib's ClientManager
+  nativeId: number;
 }
 
 interface TdlibLibraryInfo {
@@ -27,11 +31,169 @@ interface TdlibLibraryInfo {
   hasCreate: boolean;
   hasSend: boolean;
   hasReceive: boolean;
+  // TDLib serializes responses into a reusable buffer and reports their length
+  hasReceiveWithLength?: boolean;
+  // TDLib accepts td_set_scheduler_options
+  hasSchedulerOptions?: boolean;
+  // TDLib accepts td_set_binlog_sync_delay
+  hasBinlogSyncDelay?: boolean;
+  // TDLib accepts td_set_deferred_message_search_indexing
+  hasDeferredMessageSearchIndexing?: boolean;
+  // TDLib accepts td_set_use_io_uring
+  hasUseIoUring?: boolean;
+  // TDLib accepts td_set_use_ring_file_log
+  hasUseRingFileLog?: boolean;
+  // TDLib accepts td_set_client_log_verbosity_level
+  hasClientLogVerbosityLevel?: boolean;
+  // TDLib accepts td_set_heap_profile_sample_interval and td_get_heap_profile
+  hasHeapProfile?: boolean;
+  // TDLib accepts td_set_use_object_arena
+  hasUseObjectArena?: boolean;
+  // TDLib accepts td_set_test_dc_server
+  hasTestDcServer?: boolean;
   hasExecute: boolean;
   hasDestroy: boolean;
   clientCount: number;
+  receiveEngineRunning?: boolean;
+  sendPacerRunning?: boolean;
 }
 
+export interface TdlibBatchRequest {
+  clientId: string;
+  request: TdlibRequest;
+}
+
+/**
+ * Native update filter: only @type values starting with "update" are affected,
+ * and updateAuthorizationState is always delivered. Coalesced types keep only
+ * the latest update per subject within one receive engine batch.
+ */
+export interface TdlibUpdateFilter {
+  mode: 'allow' | 'deny';
+  types: string[];
+  coalesce?: string[];
+}
+
+export type TdlibUpdateFilterStats = Record<string, { dropped: number; coalesced: number }>;
+
+export interface TdlibNativeCounters {
+  requestsSent: number;
+  responsesReceived: number;
+  updatesReceived: number;
+  bytesSent: number;
+  bytesReceived: number;
+}
+
+/**
+ * Log-linear histogram summary; percentiles are bucket upper bounds, accurate
+ * to 12.5%.
+ */
+export interface TdlibNativeLatency {
+  count: number;
+  sumUs: number;
+  maxUs: number;
+  p50Us: number;
+  p90Us: number;
+  p99Us: number;
+  p999Us: number;
+}
+
+/**
+ * Hot-path instrumentation of the native addon (addon.getMetrics())
+ */
+export interface TdlibNativeMetrics {
+  clients: Array<TdlibNativeCounters & { clientId: number; status: 'open' | 'closing' | 'closed' }>;
+  totals: TdlibNativeCounters;
+  // invoke() requests awaiting their response
+  pendingRequests: number;
+  // Receive engine batches not yet delivered to the JS thread
+  deliveryBacklog: { batches: number; updates: number };
+  // invoke() send until the response is received
+  responseLatency: TdlibNativeLatency;
+  lockWait: Record<string, TdlibNativeLatency>;
+}
+
+interface TdlibUpdateStreamOptions {
+  maxBatchSize?: number;
+  flushIntervalMs?: number;
+  idleTimeoutMs?: number;
+}
+
+interface TdlibNativeUpdate {
+  clientId: number;
+  update: string;
+}
+
+/**
+ * Send rate of one account in the native send pacer. Burst is the number of
+ * sends released at once after the account has been idle.
+ */
+export interface TdlibSendPacing {
+  ratePerSecond: number;
+  burst?: number;
+}
+
+/**
+ * Outcome of one request of a paced batch. A sendMessage is "sent" only after
+ * updateMessageSendSucceeded, which is then the response; flood waits are
+ * retried natively and count in attempts.
+ */
+export interface TdlibPacedSendResult {
+  batchId: number;
+  index: number;
+  clientId: string;
+  status: 'sent' | 'failed' | 'timedOut' | 'cancelled';
+  attempts: number;
+  response?: TdlibResponse;
+  errorCode?: number;
+  errorMessage?: string;
+}
+
+export interface TdlibPacedSendSummary {
+  batchId: number;
+  sent: number;
+  failed: number;
+  timedOut: number;
+  cancelled: number;
+}
+
+export interface TdlibPacedSendOptions {
+  pacing?: TdlibSendPacing;
+  // Called with the results of the batch as the pacer reports them
+  onResults?: (results: TdlibPacedSendResult[]) => void;
+}
+
+export interface TdlibSendPacerStats {
+  clientId: string;
+  queued: number;
+  inFlight: number;
+  ratePerSecond: number;
+  pausedForMs: number;
+  sent: number;
+  failed: number;
+  floodWaits: number;
+}
+
+interface TdlibNativePacedSendResult {
+  batchId: number;
+  index: number;
+  clientId: number;
+  status: TdlibPacedSendResult['status'];
+  attempts: number;
+  response?: string;
+  errorCode?: number;
+  errorMessage?: string;
+}
+
+interface PendingPacedBatch {
+  remaining: number;
+  summary: TdlibPacedSendSummary;
+  onResults?: (results: TdlibPacedSendResult[]) => void;
+  resolve: (summary: TdlibPacedSendSummary) => void;
+}
+
+export type TdlibUpdateListener = (clientId: string, update: TdlibResponse) => void;
+
 interface ProxyConfig {
   type: 'http' | 'socks5' | 'socks4';
   server: string;
@@ -47,10 +209,32 @@ interface SendMessageOptions {
   scheduleDate?: number;
 }
 
+// Value of a numeric TDLIB_* setting; throws if it is not a number in min..max
+function parseNumberSetting(value: string | undefined, min: number, max: number, integer = false): number {
+  const number = Number(value);
+  if (!Number.isFinite(number) || number < min || number > max || (integer && !Number.isInteger(number))) {
+    throw new Error(`expected ${integer ? 'an integer in ' : ''}${min}..${max}, got ${value}`);
+  }
+  return number;
+}
+
 @Injectable()
 export class TdlibService implements OnModuleInit, OnModuleDestroy {
   private addon: any | null = null;
   private readonly clients = new Map<string, TdlibClientHandle>();
+  private readonly updateListeners = new Set<TdlibUpdateListener>();
+  private updateStreamActive = false;
+  private defaultUpdateFilter: TdlibUpdateFilter | null = null;
+  // Listener-based invoke() calls awaiting a response, by "@extra"; "listener:N"
+  // keeps them apart from the "invoke:N" tags of the addon
+  private readonly pendingInvokes = new Map<string, (response: TdlibResponse) => void>();
+  private invokeSequence = 0;
+  private invokePollTimer: NodeJS.Timeout | null = null;
+  // Number of waitForUpdate() calls awaiting an update
+  private updateWaiterCount = 0;
+  private sendPacerActive = false;
+  // Paced batches whose results are not all reported yet, by batch identifier
+  private readonly pendingPacedBatches = new Map<number, PendingPacedBatch>();
   private initializationPromise: Promise<void> | null = null;
 
   constructor(
@@ -86,6 +270,7 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       // eslint-disable-next-line @typescript-eslint/no-var-requires
       this.addon = require(addonPath);
       this.logger.log(`TDLib addon loaded from ${addonPath}`);
+      this.metrics.setTdlibNativeMetricsSource(() => this.getNativeMetrics());
 
       // Validate library can be loaded by checking library info
       if (this.addon && typeof this.addon.getLibraryInfo === 'function') {
@@ -111,10 +296,21 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
               create: info.hasCreate,
               send: info.hasSend,
               receive: info.hasReceive,
+              receiveWithLength: info.hasReceiveWithLength === true,
               execute: info.hasExecute,
               destroy: info.hasDestroy,
+              schedulerOptions: info.hasSchedulerOptions === true,
+              binlogSyncDelay: info.hasBinlogSyncDelay === true,
+              deferredMessageSearchIndexing: info.hasDeferredMessageSearchIndexing === true,
+              useIoUring: info.hasUseIoUring === true,
+              useRingFileLog: info.hasUseRingFileLog === true,
+              clientLogVerbosityLevel: info.hasClientLogVerbosityLevel === true,
+              heapProfile: info.hasHeapProfile === true,
+              useObjectArena: info.hasUseObjectArena === true,
+              testDcServer: info.hasTestDcServer === true,
             },
           });
+          this.configureNativeSettings();
         } catch (infoError) {
           // If getLibraryInfo fails, the library might not be loaded
           const errorMsg = `TDLib library validation failed: ${infoError instanceof Error ? infoError.message : String(infoError)}. ` +
@@ -150,7 +346,114 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
     }
   }
 
+  /**
+   * Apply the TDLIB_* settings of libtdjson before the first client is created;
+   * e.g. TDLib sizes its scheduler pool once, when the first client is created.
+   */
+  private configureNativeSettings(): void {
+    this.applyNativeSetting(
+      [
+        'TDLIB_SCHEDULER_INSTANCES',
+        'TDLIB_SCHEDULER_THREADS',
+        'TDLIB_SCHEDULER_PIN_THREADS',
+        'TDLIB_SCHEDULER_LOAD_AWARE',
+      ],
+      'setSchedulerOptions',
+      (instances, threads, pinThreads, loadAware) => [
+        {
+          instances: Number(instances ?? 0),
+          threadsPerInstance: Number(threads ?? 0),
+          pinThreads: pinThreads === 'true',
+          loadAware: loadAware === undefined || loadAware === 'true',
+        },
+      ],
+    );
+    // Binlog syncs of all clients requested within this window share one fsync
+    this.applyNativeSetting('TDLIB_BINLOG_SYNC_DELAY_MS', 'setBinlogSyncDelay', (delayMs) => [
+      parseNumberSetting(delayMs, 0, 1000),
+    ]);
+    // Messages are indexed for search in background batches, not inside every message write
+    this.applyNativeSetting(
+      'TDLIB_DEFERRED_MESSAGE_SEARCH_INDEXING',
+      'setDeferredMessageSearchIndexing',
+      (deferred) => [deferred === 'true'],
+    );
+    // TDLib threads wait for network events with io_uring; epoll is kept if the kernel lacks it
+    this.applyNativeSetting('TDLIB_USE_IO_URING', 'setUseIoUring', (enabled) => [enabled === 'true']);
+    // Log files set afterwards are written by a background thread fed by per-thread buffers
+    this.applyNativeSetting('TDLIB_USE_RING_FILE_LOG', 'setUseRingFileLog', (enabled) => [
+      enabled === 'true',
+    ]);
+    // TDLib built with MEMPROF=SAMPLE records one allocation per this many allocated bytes; 0 = off
+    this.applyNativeSetting(
+      'TDLIB_HEAP_PROFILE_SAMPLE_BYTES',
+      'setHeapProfileSampleInterval',
+      (bytes) => [parseNumberSetting(bytes, 0, Number.MAX_SAFE_INTEGER, true)],
+    );
+    // TDLib objects of responses and updates are allocated from per-thread memory chunks; a 64 KB chunk
+    // is freed after all of its objects, so objects kept by TDLib for a long time can increase memory usage
+    this.applyNativeSetting('TDLIB_USE_OBJECT_ARENA', 'setUseObjectArena', (enabled) => [
+      enabled === 'true',
+    ]);
+    // Clients with use_test_dc connect to this server, e.g. a local fake data center for load tests
+    this.applyNativeSetting(
+      ['TDLIB_TEST_DC_SERVER', 'TDLIB_TEST_DC_PUBLIC_KEY_FILE'],
+      'setTestDcServer',
+      (address, keyFile) => {
+        if (!address || !keyFile) {
+          throw new Error('both of them must be set');
+        }
+        return [address, fs.readFileSync(keyFile, 'utf8')];
+      },
+    );
+  }
+
+  /**
+   * Pass TDLIB_* settings to a setter of the native addon, unless none of them
+   * is set. parse turns their values into the setter's arguments and throws if
+   * they are invalid; the setter returns false if libtdjson does not support it.
+   */
+  private applyNativeSetting(
+    envName: string | string[],
+    method: string,
+    parse: (...values: Array<string | undefined>) => unknown[],
+  ): void {
+    const envNames = Array.isArray(envName) ? envName : [envName];
+    const values = envNames.map((name) => {
+      const value = this.configService.get<string>(name);
+      return value === undefined || value === '' ? undefined : String(value);
+    });
+    if (values.every((value) => value === undefined)) {
+      return;
+    }
+    const settings = envNames.join(', ');
+    if (typeof this.addon[method] !== 'function') {
+      this.logger.warn(`${settings} ignored: the native addon does not support it`);
+      return;
+    }
+
+    let args: unknown[];
+    try {
+      args = parse(...values);
+    } catch (error) {
+      const reason = error instanceof Error ? error.message : String(error);
+      this.logger.warn(`${settings} ignored: ${reason}`);
+      return;
+    }
+    if (this.addon[method](...args)) {
+      const applied = Object.fromEntries(envNames.map((name, i) => [name, values[i]]));
+      this.logger.log(`TDLib ${settings} applied`, applied);
+    } else {
+      this.logger.warn(`${settings} ignored: libtdjson does not support it or rejected the value`);
+    }
+  }
+
   onModuleDestroy() {
+    this.stopUpdateStream();
+    if (this.invokePollTimer) {
+      clearInterval(this.invokePollTimer);
+      this.invokePollTimer = null;
+    }
     this.logger.log('Destroying TDLib clients...', { count: this.clients.size });
     for (const client of this.clients.values()) {
       try {
@@ -183,16 +486,20 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
 
     try {
       // createClient returns a Promise in the new implementation
-      const clientId: string = await this.addon.createClient(() => {
+      const nativeId: number = await this.addon.createClient(() => {
         // Callback for compatibility, but Promise is preferred
       });
 
-      if (!clientId || typeof clientId !== 'string') {
+      if (typeof nativeId !== 'number' || !Number.isInteger(nativeId) || nativeId <= 0) {
         throw new Error('Failed to create TDLib client: invalid clientId returned');
       }
 
-      const handle: TdlibClientHandle = { id: clientId };
+      const clientId = String(nativeId);
+      const handle: TdlibClientHandle = { id: clientId, nativeId };
       this.clients.set(clientId, handle);
+      if (this.defaultUpdateFilter) {
+        this.applyUpdateFilter(handle, this.defaultUpdateFilter);
+      }
       this.metrics.setTdlibActiveClients(this.clients.size);
       this.metrics.incrementTdlibRequests('createClient', 'success');
       this.logger.debug('TDLib client created', { clientId, context });
@@ -213,13 +520,14 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       return;
     }
 
-    if (!this.clients.has(clientId)) {
+    const handle = this.clients.get(clientId);
+    if (!handle) {
       this.logger.warn('Attempted to destroy non-existent client', { clientId });
       return;
     }
 
     try {
-      this.addon.destroyClient(clientId);
+      this.addon.destroyClient(handle.nativeId);
       this.clients.delete(clientId);
       this.metrics.setTdlibActiveClients(this.clients.size);
       this.logger.debug('TDLib client destroyed', { clientId });
@@ -245,7 +553,8 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       throw new TdlibNotReadyException('Send function not available');
     }
 
-    if (!this.clients.has(clientId)) {
+    const handle = this.clients.get(clientId);
+    if (!handle) {
       this.metrics.incrementTdlibRequests(method, 'error');
       this.metrics.incrementTdlibErrors('client_not_found', 404);
       throw new TdlibClientNotFoundException(clientId);
@@ -290,7 +599,7 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
 
     try {
       const json = JSON.stringify(request);
-      this.addon.send(clientId, json);
+      this.addon.send(handle.nativeId, json);
       const duration = Date.now() - startTime;
       this.metrics.recordTdlibRequestDuration(method, duration);
       this.metrics.incrementTdlibRequests(method, 'success');
@@ -310,6 +619,88 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
     }
   }
 
+  /**
+   * Send many requests, possibly to different clients, in a single native call.
+   * Requests are validated up front and submitted as one newline-delimited
+   * Buffer, which the addon splits without converting each request to a
+   * string. Falls back to send() per request when the addon has no sendBatch.
+   * Returns the number of requests sent.
+   */
+  sendBatch(requests: TdlibBatchRequest[]): number {
+    if (requests.length === 0) {
+      return 0;
+    }
+
+    if (!this.addon || typeof this.addon.send !== 'function') {
+      this.metrics.incrementTdlibErrors('send_failed', 0);
+      throw new TdlibNotReadyException('Send function not available');
+    }
+
+    if (typeof this.addon.sendBatch !== 'function') {
+      for (const { clientId, request } of requests) {
+        this.send(clientId, request);
+      }
+      return requests.length;
+    }
+
+    const startTime = Date.now();
+    const nativeIds = new Int32Array(requests.length);
+    const lines = new Array<string>(requests.length);
+    let singleClient = true;
+
+    for (let i = 0; i < requests.length; i++) {
+      const { clientId, request } = requests[i];
+      const handle = this.clients.get(clientId);
+      if (!handle) {
+        this.metrics.incrementTdlibErrors('client_not_found', 404);
+        throw new TdlibClientNotFoundException(clientId);
+      }
+
+      try {
+        this.requestValidator.validate(request);
+      } catch (validationError) {
+        const errorMessage = validationError instanceof Error ? validationError.message : String(validationError);
+        this.metrics.incrementTdlibErrors('validation_failed', 0);
+        this.logger.error('TDLib batch request validation failed', {
+          clientId,
+          index: i,
+          error: errorMessage,
+        });
+        throw new TdlibInvalidArgumentException(`Request ${i} validation failed: ${errorMessage}`);
+      }
+
+      nativeIds[i] = handle.nativeId;
+      singleClient = singleClient && handle.nativeId === nativeIds[0];
+      // JSON.stringify escapes newlines, so each request stays on one line
+      lines[i] = JSON.stringify(request);
+    }
+
+    try {
+      const sent: number = this.addon.sendBatch(
+        singleClient ? nativeIds[0] : nativeIds,
+        Buffer.from(lines.join('\n'), 'utf8'),
+      );
+      this.metrics.recordTdlibRequestDuration('sendBatch', Date.now() - startTime);
+      for (const { request } of requests) {
+        this.metrics.incrementTdlibRequests(request['@type'] || 'unknown', 'success');
+      }
+      this.logger.debug('TDLib request batch sent', { count: sent, singleClient });
+      return sent;
+    } catch (error) {
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.metrics.incrementTdlibErrors('send_exception', 0);
+      this.logger.error('Failed to send TDLib request batch', {
+        count: requests.length,
+        error: errorMessage,
+      });
+      throw new TdlibSendFailedException(errorMessage);
+    }
+  }
+
+  /**
+   * Receive the next update of a client. td_receive serves every client, so
+   * updates of other clients received while waiting go to the listeners.
+   */
   receive(clientId: string, timeoutSeconds = 1.0): TdlibResponse | null {
     if (!this.addon || typeof this.addon.receive !== 'function') {
       throw new TdlibNotReadyException('Receive function not available');
@@ -326,31 +717,43 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
     }
 
     try {
-      const raw: string | null = this.addon.receive(clientId, timeoutSeconds);
-      if (!raw) {
-        return null;
-      }
+      const deadline = Date.now() + timeoutSeconds * 1000;
+      let remainingSeconds = timeoutSeconds;
+      for (;;) {
+        const raw: string | null = this.addon.receive(remainingSeconds);
+        if (!raw) {
+          return null;
+        }
+
+        let parsed: unknown;
+        try {
+          parsed = JSON.parse(raw) as unknown;
+        } catch (parseError) {
+          this.logger.error('Failed to parse TDLib JSON update', {
+            clientId,
+            error: parseError,
+            raw: raw.substring(0, 200), // Log first 200 chars
+          });
+          return null;
+        }
 
-      try {
-        const parsed = JSON.parse(raw) as unknown;
-        
         // Validate response
-        if (this.responseValidator.validate(parsed)) {
+        if (!this.responseValidator.validate(parsed)) {
+          return null;
+        }
+
+        const update = parsed as TdlibResponse;
+        const owner = (parsed as Record<string, unknown>)['@client_id'];
+        if (owner === undefined || String(owner) === clientId) {
           this.logger.debug('TDLib update received', {
             clientId,
             updateType: (parsed as Record<string, unknown>)['@type'],
           });
-          return parsed as TdlibResponse;
+          return update;
         }
-        
-        return null;
-      } catch (parseError) {
-        this.logger.error('Failed to parse TDLib JSON update', {
-          clientId,
-          error: parseError,
-          raw: raw.substring(0, 200), // Log first 200 chars
-        });
-        return null;
+
+        this.emitUpdate(String(owner), update);
+        remainingSeconds = Math.max(0, (deadline - Date.now()) / 1000);
       }
     } catch (error) {
       const errorMessage = error instanceof Error ? error.message : String(error);
@@ -364,6 +767,615 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
     }
   }
 
+  /**
+   * Receive one update for a client and hand it to the registered listeners.
+   * Used by the interval poller when the native receive engine is unavailable.
+   */
+  pollUpdates(clientId: string, timeoutSeconds = 1.0): TdlibResponse | null {
+    const update = this.receive(clientId, timeoutSeconds);
+    if (update) {
+      this.emitUpdate(clientId, update);
+    }
+    return update;
+  }
+
+  /**
+   * Register a listener for updates of all clients. Returns an unsubscribe function.
+   */
+  addUpdateListener(listener: TdlibUpdateListener): () => void {
+    this.updateListeners.add(listener);
+    return () => {
+      this.updateListeners.delete(listener);
+    };
+  }
+
+  supportsUpdateStream(): boolean {
+    return !!this.addon && typeof this.addon.startReceiveEngine === 'function';
+  }
+
+  isUpdateStreamActive(): boolean {
+    return this.updateStreamActive;
+  }
+
+  /**
+   * Start the native receive engine. Updates of all clients are drained by a
+   * single td_receive loop on a background thread and delivered to the
+   * listeners in batches, so the event loop never blocks inside td_receive.
+   */
+  startUpdateStream(options: TdlibUpdateStreamOptions = {}): boolean {
+    if (!this.supportsUpdateStream()) {
+      return false;
+    }
+    if (this.updateStreamActive) {
+      return true;
+    }
+
+    try {
+      const effective = this.addon.startReceiveEngine(
+        (batch: TdlibNativeUpdate[]) => this.handleUpdateBatch(batch),
+        options,
+      );
+      this.updateStreamActive = true;
+      this.logger.log('TDLib receive engine started', effective);
+      return true;
+    } catch (error) {
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.logger.error('Failed to start TDLib receive engine', { error: errorMessage });
+      return false;
+    }
+  }
+
+  stopUpdateStream(): void {
+    if (!this.updateStreamActive) {
+      return;
+    }
+    // Paced sends are finished by responses the receive engine observes
+    this.stopSendPacer();
+
+    try {
+      this.addon.stopReceiveEngine();
+    } catch (error) {
+      this.logger.error('Failed to stop TDLib receive engine', {
+        error: error instanceof Error ? error.message : String(error),
+      });
+    }
+    this.updateStreamActive = false;
+    this.logger.log('TDLib receive engine stopped');
+  }
+
+  supportsUpdateFilter(): boolean {
+    return !!this.addon && typeof this.addon.setUpdateFilter === 'function';
+  }
+
+  /**
+   * Filter the updates of one client in the addon, before they are turned into
+   * JS strings. Pass null to deliver every update again.
+   */
+  setUpdateFilter(clientId: string, filter: TdlibUpdateFilter | null): void {
+    const handle = this.clients.get(clientId);
+    if (!handle) {
+      throw new TdlibClientNotFoundException(clientId);
+    }
+    if (!this.supportsUpdateFilter()) {
+      throw new TdlibNotReadyException('Update filtering not supported by the TDLib addon');
+    }
+    this.applyUpdateFilter(handle, filter);
+  }
+
+  /**
+   * Set the filter installed on every existing and future client. Ignored when
+   * the addon does not support filtering.
+   */
+  setDefaultUpdateFilter(filter: TdlibUpdateFilter | null): boolean {
+    if (!this.supportsUpdateFilter()) {
+      return false;
+    }
+    this.defaultUpdateFilter = filter;
+    for (const handle of this.clients.values()) {
+      this.applyUpdateFilter(handle, filter);
+    }
+    return true;
+  }
+
+  /**
+   * Log one client up to the given TDLib verbosity level even if the global
+   * level is lower, without slowing down logging of other clients. Pass a
+   * negative level to use the global level again. Returns false when TDLib
+   * does not support per-client verbosity.
+   */
+  setClientLogVerbosityLevel(clientId: string, level: number): boolean {
+    const handle = this.clients.get(clientId);
+    if (!handle) {
+      throw new TdlibClientNotFoundException(clientId);
+    }
+    if (!this.addon || typeof this.addon.setClientLogVerbosityLevel !== 'function') {
+      return false;
+    }
+    if (!Number.isInteger(level)) {
+      throw new TdlibInvalidArgumentException(`Invalid log verbosity level: ${level}`);
+    }
+    return this.addon.setClientLogVerbosityLevel(handle.nativeId, level) === true;
+  }
+
+  /**
+   * Heap profile of memory allocated by one client, or by the whole process if
+   * no client is given, in the text format read by pprof. Sites are sorted by
+   * live sampled size. Returns null when TDLib does not support heap profiling;
+   * the profile has no sites unless TDLib is built with MEMPROF=SAMPLE.
+   */
+  getHeapProfile(clientId?: string): string | null {
+    let nativeId = 0;
+    if (clientId !== undefined) {
+      const handle = this.clients.get(clientId);
+      if (!handle) {
+        throw new TdlibClientNotFoundException(clientId);
+      }
+      nativeId = handle.nativeId;
+    }
+    if (!this.addon || typeof this.addon.getHeapProfile !== 'function') {
+      return null;
+    }
+    const profile = this.addon.getHeapProfile(nativeId);
+    return typeof profile === 'string' ? profile : null;
+  }
+
+  getUpdateFilterStats(): TdlibUpdateFilterStats {
+    if (!this.addon || typeof this.addon.getUpdateFilterStats !== 'function') {
+      return {};
+    }
+    return this.addon.getUpdateFilterStats() as TdlibUpdateFilterStats;
+  }
+
+  /**
+   * Counters and latency histograms kept by the addon; null when the addon
+   * does not provide them. Cheap enough to call on every metrics scrape.
+   */
+  getNativeMetrics(): TdlibNativeMetrics | null {
+    if (!this.addon || typeof this.addon.getMetrics !== 'function') {
+      return null;
+    }
+    return this.addon.getMetrics() as TdlibNativeMetrics;
+  }
+
+  private applyUpdateFilter(handle: TdlibClientHandle, filter: TdlibUpdateFilter | null): void {
+    try {
+      this.addon.setUpdateFilter(handle.nativeId, filter);
+    } catch (error) {
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.logger.error('Failed to set TDLib update filter', {
+        clientId: handle.id,
+        error: errorMessage,
+      });
+      throw new TdlibInvalidArgumentException(`Invalid update filter: ${errorMessage}`);
+    }
+  }
+
+  private handleUpdateBatch(batch: TdlibNativeUpdate[]): void {
+    for (const item of batch) {
+      let parsed: unknown;
+      try {
+        parsed = JSON.parse(item.update);
+      } catch (parseError) {
+        this.logger.error('Failed to parse TDLib JSON update', {
+          clientId: String(item.clientId),
+          error: parseError,
+          raw: item.update.substring(0, 200),
+        });
+        continue;
+      }
+
+      if (this.responseValidator.validate(parsed)) {
+        this.emitUpdate(String(item.clientId), parsed as TdlibResponse);
+      }
+    }
+  }
+
+  private emitUpdate(clientId: string, update: TdlibResponse): void {
+    const extra = (update as Record<string, unknown>)['@extra'];
+    if (typeof extra === 'string' && this.pendingInvokes.has(extra)) {
+      const settle = this.pendingInvokes.get(extra)!;
+      this.pendingInvokes.delete(extra);
+      settle(update);
+      return;
+    }
+
+    for (const listener of this.updateListeners) {
+      try {
+        listener(clientId, update);
+      } catch (error) {
+        this.logger.error('TDLib update listener failed', {
+          clientId,
+          updateType: update['@type'],
+          error: error instanceof Error ? error.message : String(error),
+        });
+      }
+    }
+  }
+
+  supportsSendPacing(): boolean {
+    return this.updateStreamActive && typeof this.addon.enqueueSends === 'function';
+  }
+
+  /**
+   * Queue requests of one account in the native send pacer, which releases
+   * them at the account's rate, backs off only this account on FLOOD_WAIT and
+   * SLOWMODE_WAIT errors and retries the affected request. Needs the running
+   * receive engine, which observes the results, and starts the pacer if needed.
+   * Any "@extra" of the requests is removed.
+   * The promise resolves once every request has a result.
+   */
+  sendPaced(
+    clientId: string,
+    requests: TdlibRequest[],
+    options: TdlibPacedSendOptions = {},
+  ): { batchId: number; done: Promise<TdlibPacedSendSummary> } {
+    const handle = this.clients.get(clientId);
+    if (!handle) {
+      throw new TdlibClientNotFoundException(clientId);
+    }
+    if (!this.supportsSendPacing()) {
+      throw new TdlibNotReadyException('Send pacing not supported by the TDLib addon');
+    }
+
+    const payloads = requests.map((request) => {
+      try {
+        this.requestValidator.validate(request);
+      } catch (validationError) {
+        const errorMessage = validationError instanceof Error ? validationError.message : String(validationError);
+        throw new TdlibInvalidArgumentException(`Request validation failed: ${errorMessage}`);
+      }
+      const payload = { ...request } as Record<string, unknown>;
+      delete payload['@extra'];
+      return JSON.stringify(payload);
+    });
+
+    if (!this.startSendPacer()) {
+      throw new TdlibNotReadyException('TDLib send pacer could not be started');
+    }
+
+    let batchId: number;
+    try {
+      batchId = this.addon.enqueueSends(handle.nativeId, payloads, options.pacing);
+    } catch (error) {
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.metrics.incrementTdlibErrors('send_exception', 0);
+      throw new TdlibSendFailedException(errorMessage);
+    }
+
+    const summary: TdlibPacedSendSummary = { batchId, sent: 0, failed: 0, timedOut: 0, cancelled: 0 };
+    const done = new Promise<TdlibPacedSendSummary>((resolve) => {
+      if (payloads.length === 0) {
+        resolve(summary);
+        return;
+      }
+      this.pendingPacedBatches.set(batchId, {
+        remaining: payloads.length,
+        summary,
+        onResults: options.onResults,
+        resolve,
+      });
+    });
+    return { batchId, done };
+  }
+
+  /**
+   * Drop the requests of a paced batch that are not released yet; they are
+   * reported as cancelled. Returns their number.
+   */
+  cancelPacedSends(batchId: number): number {
+    if (!this.sendPacerActive) {
+      return 0;
+    }
+    return this.addon.cancelSends(batchId) as number;
+  }
+
+  /**
+   * Per-account pacer state. Accounts with nothing queued or in flight are
+   * dropped once their bucket refills, so counters restart with the next send.
+   */
+  getSendPacerStats(): TdlibSendPacerStats[] {
+    if (!this.addon || typeof this.addon.getSendPacerStats !== 'function') {
+      return [];
+    }
+    const stats = this.addon.getSendPacerStats() as Array<Omit<TdlibSendPacerStats, 'clientId'> & { clientId: number }>;
+    return stats.map((account) => ({ ...account, clientId: String(account.clientId) }));
+  }
+
+  private startSendPacer(): boolean {
+    if (this.sendPacerActive) {
+      return true;
+    }
+
+    const options: Record<string, number> = {};
+    const settings: Array<[string, string]> = [
+      ['TDLIB_SEND_PACER_MAX_IN_FLIGHT', 'maxInFlight'],
+      ['TDLIB_SEND_PACER_TIMEOUT_MS', 'timeoutMs'],
+      ['TDLIB_SEND_PACER_MAX_RETRIES', 'maxRetries'],
+    ];
+    for (const [key, option] of settings) {
+      const value = this.configService.get<string>(key);
+      if (value !== undefined && Number.isFinite(Number(value)) && Number(value) >= 0) {
+        options[option] = Number(value);
+      }
+    }
+
+    try {
+      const effective = this.addon.startSendPacer(
+        (results: TdlibNativePacedSendResult[]) => this.handlePacedSendResults(results),
+        options,
+      );
+      this.sendPacerActive = true;
+      this.logger.log('TDLib send pacer started', effective);
+      return true;
+    } catch (error) {
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.logger.error('Failed to start TDLib send pacer', { error: errorMessage });
+      return false;
+    }
+  }
+
+  /**
+   * Stop the send pacer; requests not finished yet are reported as cancelled
+   */
+  stopSendPacer(): void {
+    if (!this.sendPacerActive) {
+      return;
+    }
+
+    try {
+      this.addon.stopSendPacer();
+    } catch (error) {
+      this.logger.error('Failed to stop TDLib send pacer', {
+        error: error instanceof Error ? error.message : String(error),
+      });
+    }
+    this.sendPacerActive = false;
+    this.logger.log('TDLib send pacer stopped');
+  }
+
+  private handlePacedSendResults(results: TdlibNativePacedSendResult[]): void {
+    const resultsByBatch = new Map<number, TdlibPacedSendResult[]>();
+    for (const item of results) {
+      const batch = this.pendingPacedBatches.get(item.batchId);
+      if (!batch) {
+        continue;
+      }
+
+      const result: TdlibPacedSendResult = {
+        batchId: item.batchId,
+        index: item.index,
+        clientId: String(item.clientId),
+        status: item.status,
+        attempts: item.attempts,
+      };
+      if (item.response !== undefined) {
+        try {
+          const response = JSON.parse(item.response) as Record<string, unknown>;
+          delete response['@extra'];
+          result.response = response as TdlibResponse;
+        } catch (parseError) {
+          this.logger.error('Failed to parse TDLib paced send response', {
+            clientId: result.clientId,
+            error: parseError,
+            raw: item.response.substring(0, 200),
+          });
+        }
+      }
+      if (item.status === 'failed') {
+        result.errorCode = item.errorCode;
+        result.errorMessage = item.errorMessage;
+        this.metrics.incrementTdlibErrors('paced_send_failed', item.errorCode ?? 0);
+      }
+
+      batch.summary[item.status]++;
+      batch.remaining--;
+      const batchResults = resultsByBatch.get(item.batchId);
+      if (batchResults) {
+        batchResults.push(result);
+      } else {
+        resultsByBatch.set(item.batchId, [result]);
+      }
+    }
+
+    for (const [batchId, batchResults] of resultsByBatch) {
+      const batch = this.pendingPacedBatches.get(batchId)!;
+      if (batch.onResults) {
+        try {
+          batch.onResults(batchResults);
+        } catch (error) {
+          this.logger.error('TDLib paced send result listener failed', {
+            batchId,
+            error: error instanceof Error ? error.message : String(error),
+          });
+        }
+      }
+      if (batch.remaining <= 0) {
+        this.pendingPacedBatches.delete(batchId);
+        batch.resolve(batch.summary);
+      }
+    }
+  }
+
+  supportsInvoke(): boolean {
+    return !!this.addon && typeof this.addon.invoke === 'function';
+  }
+
+  /**
+   * Send a request and resolve with its response, or null on timeout. TDLib
+   * errors are returned as error objects. While the receive engine runs, the
+   * addon tags the request and settles the promise natively; otherwise the
+   * response is matched on "@extra" by an update listener. Any "@extra" of the
+   * request is replaced.
+   */
+  async invoke(clientId: string, request: TdlibRequest, timeoutMs = 30000): Promise<TdlibResponse | null> {
+    const method = request['@type'] || 'unknown';
+    const handle = this.clients.get(clientId);
+    if (!handle) {
+      this.metrics.incrementTdlibRequests(method, 'error');
+      this.metrics.incrementTdlibErrors('client_not_found', 404);
+      throw new TdlibClientNotFoundException(clientId);
+    }
+
+    try {
+      this.requestValidator.validate(request);
+    } catch (validationError) {
+      const errorMessage = validationError instanceof Error ? validationError.message : String(validationError);
+      this.metrics.incrementTdlibRequests(method, 'error');
+      this.metrics.incrementTdlibErrors('validation_failed', 0);
+      throw new TdlibInvalidArgumentException(`Request validation failed: ${errorMessage}`);
+    }
+
+    const payload = { ...request } as Record<string, unknown>;
+    delete payload['@extra'];
+
+    const startTime = Date.now();
+    const response =
+      this.updateStreamActive && this.supportsInvoke()
+        ? await this.invokeNative(handle, payload, timeoutMs)
+        : await this.invokeWithListener(handle, payload, timeoutMs);
+
+    this.metrics.recordTdlibRequestDuration(method, Date.now() - startTime);
+    this.metrics.incrementTdlibRequests(method, response && response['@type'] !== 'error' ? 'success' : 'error');
+    if (!response) {
+      this.metrics.incrementTdlibErrors('request_timeout', 0);
+      this.logger.warn('TDLib request timed out', { clientId, requestType: method, timeoutMs });
+    }
+    return response;
+  }
+
+  private async invokeNative(
+    handle: TdlibClientHandle,
+    payload: Record<string, unknown>,
+    timeoutMs: number,
+  ): Promise<TdlibResponse | null> {
+    let raw: string;
+    try {
+      raw = await this.addon.invoke(handle.nativeId, JSON.stringify(payload), timeoutMs);
+    } catch (error) {
+      if ((error as { code?: string })?.code === 'ETIMEDOUT') {
+        return null;
+      }
+      const errorMessage = error instanceof Error ? error.message : String(error);
+      this.metrics.incrementTdlibErrors('send_exception', 0);
+      throw new TdlibSendFailedException(errorMessage);
+    }
+
+    const parsed = JSON.parse(raw) as Record<string, unknown>;
+    delete parsed['@extra'];
+    return parsed as TdlibResponse;
+  }
+
+  private invokeWithListener(
+    handle: TdlibClientHandle,
+    payload: Record<string, unknown>,
+    timeoutMs: number,
+  ): Promise<TdlibResponse | null> {
+    const extra = `listener:${++this.invokeSequence}`;
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        if (this.pendingInvokes.delete(extra)) {
+          resolve(null);
+        }
+      }, timeoutMs);
+      this.pendingInvokes.set(extra, (response) => {
+        clearTimeout(timer);
+        const result = { ...response } as Record<string, unknown>;
+        delete result['@extra'];
+        resolve(result as TdlibResponse);
+      });
+
+      try {
+        this.send(handle.id, { ...payload, '@extra': extra } as TdlibRequest);
+      } catch (error) {
+        clearTimeout(timer);
+        this.pendingInvokes.delete(extra);
+        reject(error);
+        return;
+      }
+      this.ensureInvokePolling();
+    });
+  }
+
+  /**
+   * invoke() for callers that need a response of one @type: TDLib errors, a
+   * response of another type and timeouts are thrown
+   */
+  async invokeExpecting(
+    clientId: string,
+    request: TdlibRequest,
+    expectedType: string,
+    timeoutMs = 10000,
+  ): Promise<TdlibResponse> {
+    const method = request['@type'] || 'unknown';
+    const response = await this.invoke(clientId, request, timeoutMs);
+    if (!response) {
+      throw new Error(`Timeout waiting for ${method} response`);
+    }
+    if (response['@type'] === 'error') {
+      const error = response as TdlibError;
+      throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
+    }
+    if (response['@type'] !== expectedType) {
+      throw new Error(`Unexpected ${response['@type']} response to ${method}, expected ${expectedType}`);
+    }
+    return response;
+  }
+
+  /**
+   * Resolve with the first update of a client that matches, or null on
+   * timeout. Updates are observed like any listener's, so nothing blocks in
+   * receive() while waiting.
+   */
+  waitForUpdate(
+    clientId: string,
+    matches: (update: TdlibResponse) => boolean,
+    timeoutMs: number,
+  ): Promise<TdlibResponse | null> {
+    return new Promise((resolve) => {
+      const finish = (update: TdlibResponse | null) => {
+        clearTimeout(timer);
+        unsubscribe();
+        this.updateWaiterCount--;
+        resolve(update);
+      };
+      const unsubscribe = this.addUpdateListener((updateClientId, update) => {
+        if (updateClientId === clientId && matches(update)) {
+          finish(update);
+        }
+      });
+      const timer = setTimeout(() => finish(null), timeoutMs);
+      this.updateWaiterCount++;
+      this.ensureInvokePolling();
+    });
+  }
+
+  /**
+   * Without the receive engine nothing may be receiving, so drain responses
+   * while listener-based invoke() or waitForUpdate() calls are outstanding
+   */
+  private ensureInvokePolling(): void {
+    if (this.invokePollTimer) {
+      return;
+    }
+    this.invokePollTimer = setInterval(() => {
+      if ((this.pendingInvokes.size === 0 && this.updateWaiterCount === 0) || this.updateStreamActive) {
+        clearInterval(this.invokePollTimer!);
+        this.invokePollTimer = null;
+        return;
+      }
+      const clientId = this.clients.keys().next().value as string | undefined;
+      if (!clientId) {
+        return;
+      }
+      // td_receive serves every client; updates of other clients go to listeners
+      for (let i = 0; i < 100 && (this.pendingInvokes.size > 0 || this.updateWaiterCount > 0); i++) {
+        if (!this.pollUpdates(clientId, 0)) {
+          break;
+        }
+      }
+    }, 50);
+  }
+
   execute(request: TdlibRequest): TdlibResponse | null {
     if (!this.addon || typeof this.addon.execute !== 'function') {
       throw new TdlibNotReadyException('Execute function not available');
@@ -463,6 +1475,75 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       throw new TdlibClientNotFoundException(clientId);
     }
 
+    this.send(clientId, this.buildSendMessageRequest(chatId, message, options));
+    this.logger.debug('Message send requested', {
+      clientId,
+      chatId,
+      hasOptions: Object.keys(options).length > 0,
+    });
+  }
+
+  /**
+   * Send a message and resolve with the sent message once TDLib reports it
+   * sent, an error object if sending failed, or null on timeout. Scheduled
+   * messages resolve as soon as they are accepted.
+   */
+  async sendMessageAndWait(
+    clientId: string,
+    chatId: number | string,
+    message: string,
+    options: SendMessageOptions = {},
+    timeoutMs = 10000,
+  ): Promise<TdlibResponse | null> {
+    if (!this.clients.has(clientId)) {
+      throw new TdlibClientNotFoundException(clientId);
+    }
+
+    const deadline = Date.now() + timeoutMs;
+    const isSendResult = (update: TdlibResponse) =>
+      update['@type'] === 'updateMessageSendSucceeded' || update['@type'] === 'updateMessageSendFailed';
+    // The result may be delivered in the same batch as the response, so collect results from before sending
+    const results = new Map<number, Record<string, unknown>>();
+    const unsubscribe = this.addUpdateListener((updateClientId, update) => {
+      if (updateClientId === clientId && isSendResult(update)) {
+        const fields = update as Record<string, unknown>;
+        results.set(Number(fields.old_message_id), fields);
+      }
+    });
+
+    try {
+      const pending = await this.invoke(clientId, this.buildSendMessageRequest(chatId, message, options), timeoutMs);
+      const pendingId = Number((pending as Record<string, unknown> | null)?.id);
+      if (!pending || pending['@type'] !== 'message' || !(pending as Record<string, unknown>).sending_state) {
+        return pending;
+      }
+
+      const result =
+        results.get(pendingId) ??
+        ((await this.waitForUpdate(
+          clientId,
+          (update) => isSendResult(update) && Number((update as Record<string, unknown>).old_message_id) === pendingId,
+          Math.max(0, deadline - Date.now()),
+        )) as Record<string, unknown> | null);
+      if (!result) {
+        return null;
+      }
+      if (result['@type'] === 'updateMessageSendSucceeded') {
+        return result.message as TdlibResponse;
+      }
+      // TDLib reports the failure as error, older versions as error_code and error_message
+      const error = (result.error ?? { code: result.error_code, message: result.error_message }) as TdlibError;
+      return { '@type': 'error', code: error.code, message: error.message } as TdlibResponse;
+    } finally {
+      unsubscribe();
+    }
+  }
+
+  private buildSendMessageRequest(
+    chatId: number | string,
+    message: string,
+    options: SendMessageOptions,
+  ): TdlibRequest {
     const request: TdlibRequest = {
       '@type': 'sendMessage',
       chat_id: typeof chatId === 'string' ? parseInt(chatId, 10) : chatId,
@@ -489,13 +1570,7 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
         send_date: options.scheduleDate,
       };
     }
-
-    this.send(clientId, request);
-    this.logger.debug('Message send requested', {
-      clientId,
-      chatId,
-      hasOptions: Object.keys(options).length > 0,
-    });
+    return request;
   }
 
   /**
@@ -506,30 +1581,25 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       throw new TdlibClientNotFoundException(clientId);
     }
 
-    this.send(clientId, {
-      '@type': 'getMe',
-    } as TdlibRequest);
+    return this.invokeExpecting(clientId, { '@type': 'getMe' } as TdlibRequest, 'user', 5000);
+  }
 
-    // Wait for response
-    const deadline = Date.now() + 5000; // 5 second timeout
-    while (Date.now() < deadline) {
-      const update = this.receive(clientId, 1.0);
-      if (update) {
-        if (update['@type'] === 'user') {
-          return update;
-        }
-        if (update['@type'] === 'error') {
-          const error = update as TdlibError;
-          throw new Error(`TDLib error: ${error.message} (code: ${error.code})`);
-        }
-      }
+  /**
+   * Rebuild the message search index of a client in one bulk pass, e.g. after
+   * importing many messages with TDLIB_DEFERRED_MESSAGE_SEARCH_INDEXING on.
+   * Takes long for big message databases, hence the long default timeout.
+   */
+  async rebuildMessageSearchIndex(clientId: string, timeoutMs = 600000): Promise<void> {
+    if (!this.clients.has(clientId)) {
+      throw new TdlibClientNotFoundException(clientId);
     }
 
-    throw new Error('Timeout waiting for getMe response');
+    await this.invokeExpecting(clientId, { '@type': 'rebuildMessageSearchIndex' } as TdlibRequest, 'ok', timeoutMs);
   }
 
   /**
-   * Get chats list
+   * Get chats list: the full chat objects of the first chats of the main list,
+   * fetched concurrently. Chats that cannot be fetched are left out.
    */
   async getChats(
     clientId: string,
@@ -540,35 +1610,28 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       throw new TdlibClientNotFoundException(clientId);
     }
 
-    this.send(clientId, {
-      '@type': 'getChats',
-      chat_list: {
-        '@type': 'chatListMain',
-      },
-      limit,
-      offset_order: offset,
-      offset_chat_id: 0,
-    } as TdlibRequest);
-
-    // Collect chat updates
-    const chats: TdlibResponse[] = [];
-    const deadline = Date.now() + 10000; // 10 second timeout
-
-    while (Date.now() < deadline && chats.length < limit) {
-      const update = this.receive(clientId, 1.0);
-      if (update) {
-        if (update['@type'] === 'chat') {
-          chats.push(update);
-        } else if (update['@type'] === 'updateChatLastMessage') {
-          // Chat list update, continue collecting
-          continue;
-        } else if (update['@type'] === 'error') {
-          break;
-        }
-      }
+    const response = await this.invoke(
+      clientId,
+      {
+        '@type': 'getChats',
+        chat_list: {
+          '@type': 'chatListMain',
+        },
+        limit,
+        offset_order: offset,
+        offset_chat_id: 0,
+      } as TdlibRequest,
+      10000, // 10 second timeout
+    );
+
+    if (!response || response['@type'] !== 'chats') {
+      return [];
     }
-
-    return chats;
+    const chatIds = ((response as Record<string, unknown>).chat_ids as number[]) || [];
+    const chats = await Promise.all(
+      chatIds.map((chatId) => this.invoke(clientId, { '@type': 'getChat', chat_id: chatId } as TdlibRequest, 10000)),
+    );
+    return chats.filter((chat): chat is TdlibResponse => !!chat && chat['@type'] === 'chat');
   }
 
   /**
@@ -579,31 +1642,21 @@ export class TdlibService implements OnModuleInit, OnModuleDestroy {
       throw new TdlibClientNotFoundException(clientId);
     }
 
-    this.send(clientId, {
-      '@type': 'searchContacts',
-      query,
-      limit,
-    } as TdlibRequest);
-
-    const contacts: TdlibResponse[] = [];
-    const deadline = Date.now() + 5000;
-
-    while (Date.now() < deadline && contacts.length < limit) {
-      const update = this.receive(clientId, 1.0);
-      if (update) {
-        if (update['@type'] === 'users') {
-          const usersResponse = update as Record<string, unknown>;
-          const userIds = (usersResponse.user_ids as unknown[]) || [];
-          contacts.push(...userIds.map(id => ({ '@type': 'user', id } as TdlibResponse)));
-          break;
-        }
-        if (update['@type'] === 'error') {
-          break;
-        }
-      }
+    const response = await this.invoke(
+      clientId,
+      {
+        '@type': 'searchContacts',
+        query,
+        limit,
+      } as TdlibRequest,
+      5000,
+    );
+
+    if (!response || response['@type'] !== 'users') {
+      return [];
     }
-
-    return contacts;
+    const userIds = ((response as Record<string, unknown>).user_ids as unknown[]) || [];
+    return userIds.map((id) => ({ '@type': 'user', id } as TdlibResponse));
   }
 
   getClientCount(): number {
@@ -13750,6 +13750,7 @@ export interface TdlibgetStorageStatistics {
 
 
 
+
 export interface TdliboptimizeStorage {
   "@type": "optimizeStorage";
   size: number;
@@ -19605,6 +19606,7 @@ export type TdlibResponse =
   | TdlibgetStorageStatistics
   | TdlibgetStorageStatisticsFast
   | TdlibgetDatabaseStatistics
+  | TdlibrebuildMessageSearchIndex
   | TdliboptimizeStorage
   | TdlibgetNetworkStatistics
   | TdlibgetAutoDownloadSettingsPresets
@@ -22,8 +22,7 @@ describe('MessageProcessor', () => {
     };
 
     mockTdlibService = {
-      sendMessage: jest.fn(),
-      receive: jest.fn(),
+      sendMessageAndWait: jest.fn(),
     };
 
     mockSessionStore = {
@@ -110,8 +109,7 @@ describe('MessageProcessor', () => {
       };
 
       mockSessionStore.getSessionsByAccountId.mockResolvedValue([session]);
-      mockTdlibService.sendMessage.mockResolvedValue(undefined);
-      mockTdlibService.receive.mockReturnValue({
+      mockTdlibService.sendMessageAndWait.mockResolvedValue({
         '@type': 'message',
         id: 100,
         date: Math.floor(Date.now() / 1000),
@@ -127,7 +125,7 @@ describe('MessageProcessor', () => {
         attemptsMade: 0,
       });
 
-      expect(mockTdlibService.sendMessage).toHaveBeenCalled();
+      expect(mockTdlibService.sendMessageAndWait).toHaveBeenCalled();
       expect(mockPrismaService.message.update).toHaveBeenCalled();
       expect(result.status).toBe('sent');
     });
@@ -148,8 +146,7 @@ describe('MessageProcessor', () => {
       };
 
       mockSessionStore.getSessionsByAccountId.mockResolvedValue([session]);
-      mockTdlibService.sendMessage.mockResolvedValue(undefined);
-      mockTdlibService.receive.mockReturnValue({
+      mockTdlibService.sendMessageAndWait.mockResolvedValue({
         '@type': 'message',
         id: 100,
       });
@@ -205,8 +202,7 @@ describe('MessageProcessor', () => {
       };
 
       mockSessionStore.getSessionsByAccountId.mockResolvedValue([session]);
-      mockTdlibService.sendMessage.mockResolvedValue(undefined);
-      mockTdlibService.receive.mockReturnValue({
+      mockTdlibService.sendMessageAndWait.mockResolvedValue({
         '@type': 'error',
         code: 400,
         message: 'Bad request',
@@ -240,7 +236,7 @@ describe('MessageProcessor', () => {
       });
 
       expect(result).toBeUndefined();
-      expect(mockTdlibService.sendMessage).not.toHaveBeenCalled();
+      expect(mockTdlibService.sendMessageAndWait).not.toHaveBeenCalled();
     });
   });
 });
@@ -22,7 +22,7 @@ describe('TdlibAuthService', () => {
     mockTdlibService = {
       createClient: jest.fn(),
       send: jest.fn(),
-      receive: jest.fn(),
+      waitForUpdate: jest.fn(),
       destroyClient: jest.fn(),
     };
 
@@ -338,11 +338,14 @@ describe('TdlibAuthService', () => {
       const clientId = 'client-456';
       const expectedStates = ['authorizationStateWaitCode', 'authorizationStateReady'];
 
-      mockTdlibService.receive.mockReturnValue({
-        '@type': 'updateAuthorizationState',
-        authorization_state: {
-          '@type': 'authorizationStateWaitCode',
-        },
+      mockTdlibService.waitForUpdate.mockImplementation(async (_clientId: string, matches: (update: any) => boolean) => {
+        const update = {
+          '@type': 'updateAuthorizationState',
+          authorization_state: {
+            '@type': 'authorizationStateWaitCode',
+          },
+        };
+        return matches(update) ? update : null;
       });
 
       const result = await (service as any).waitForAuthorizationState(clientId, expectedStates);
@@ -357,7 +360,7 @@ describe('TdlibAuthService', () => {
         return 60000;
       });
 
-      mockTdlibService.receive.mockReturnValue(null);
+      mockTdlibService.waitForUpdate.mockResolvedValue(null);
 
       const result = await (service as any).waitForAuthorizationState(
         clientId,
@@ -370,11 +373,14 @@ describe('TdlibAuthService', () => {
     it('should handle authorization closed state', async () => {
       const clientId = 'client-456';
 
-      mockTdlibService.receive.mockReturnValue({
-        '@type': 'updateAuthorizationState',
-        authorization_state: {
-          '@type': 'authorizationStateClosed',
-        },
+      mockTdlibService.waitForUpdate.mockImplementation(async (_clientId: string, matches: (update: any) => boolean) => {
+        const update = {
+          '@type': 'updateAuthorizationState',
+          authorization_state: {
+            '@type': 'authorizationStateClosed',
+          },
+        };
+        return matches(update) ? update : null;
       });
 
       await expect(
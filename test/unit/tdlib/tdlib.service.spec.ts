@@ -50,6 +50,7 @@ describe('TdlibService', () => {
       incrementTdlibRequests: jest.fn(),
       recordTdlibRequestDuration: jest.fn(),
       incrementTdlibErrors: jest.fn(),
+      setTdlibNativeMetricsSource: jest.fn(),
     };
 
     const module: TestingModule = await Test.createTestingModule({
@@ -113,12 +114,13 @@ describe('TdlibService', () => {
 
   describe('createClient', () => {
     it('should create a client successfully', async () => {
-      const mockClientId = 'client-123';
+      const mockClientId = 123;
       mockAddon.createClient.mockResolvedValue(mockClientId);
 
       const result = await service.createClient({ phoneNumber: '+1234567890' });
 
-      expect(result.id).toBe(mockClientId);
+      expect(result.id).toBe('123');
+      expect(result.nativeId).toBe(mockClientId);
       expect(mockAddon.createClient).toHaveBeenCalled();
       expect(mockMetrics.setTdlibActiveClients).toHaveBeenCalled();
       expect(mockMetrics.incrementTdlibRequests).toHaveBeenCalledWith('createClient', 'success');
@@ -145,12 +147,12 @@ describe('TdlibService', () => {
 
   describe('destroyClient', () => {
     it('should destroy a client successfully', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       service.destroyClient(clientId);
 
-      expect(mockAddon.destroyClient).toHaveBeenCalledWith(clientId);
+      expect(mockAddon.destroyClient).toHaveBeenCalledWith(123);
       expect((service as any).clients.has(clientId)).toBe(false);
       expect(mockMetrics.setTdlibActiveClients).toHaveBeenCalled();
     });
@@ -164,8 +166,8 @@ describe('TdlibService', () => {
     });
 
     it('should handle destroy failure', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
       mockAddon.destroyClient.mockImplementation(() => {
         throw new Error('Destroy failed');
       });
@@ -177,20 +179,20 @@ describe('TdlibService', () => {
 
   describe('send', () => {
     it('should send request successfully', () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const request = { '@type': 'getMe' };
-      (service as any).clients.set(clientId, { id: clientId });
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       service.send(clientId, request);
 
-      expect(mockAddon.send).toHaveBeenCalledWith(clientId, JSON.stringify(request));
+      expect(mockAddon.send).toHaveBeenCalledWith(123, JSON.stringify(request));
       expect(mockMetrics.incrementTdlibRequests).toHaveBeenCalledWith('getMe', 'success');
       expect(mockMetrics.recordTdlibRequestDuration).toHaveBeenCalled();
     });
 
     it('should throw TdlibNotReadyException when addon is not ready', () => {
       (service as any).addon = null;
-      const clientId = 'client-123';
+      const clientId = '123';
 
       expect(() => service.send(clientId, {})).toThrow(TdlibNotReadyException);
     });
@@ -202,8 +204,8 @@ describe('TdlibService', () => {
     });
 
     it('should handle send errors', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
       mockAddon.send.mockImplementation(() => {
         throw new Error('Send failed');
       });
@@ -213,22 +215,88 @@ describe('TdlibService', () => {
     });
   });
 
+  describe('sendBatch', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).clients.set('1', { id: '1', nativeId: 1 });
+      (service as any).clients.set('2', { id: '2', nativeId: 2 });
+    });
+
+    it('should send requests for one client as a single newline-delimited buffer', () => {
+      mockAddon.sendBatch = jest.fn().mockReturnValue(2);
+
+      const sent = service.sendBatch([
+        { clientId: '1', request: { '@type': 'getMe' } },
+        { clientId: '1', request: { '@type': 'getOption', name: 'version' } },
+      ]);
+
+      expect(sent).toBe(2);
+      expect(mockAddon.sendBatch).toHaveBeenCalledTimes(1);
+      const [clientArg, payload] = mockAddon.sendBatch.mock.calls[0];
+      expect(clientArg).toBe(1);
+      expect(Buffer.isBuffer(payload)).toBe(true);
+      expect(payload.toString('utf8').split('\n').map((line: string) => JSON.parse(line))).toEqual([
+        { '@type': 'getMe' },
+        { '@type': 'getOption', name: 'version' },
+      ]);
+      expect(mockAddon.send).not.toHaveBeenCalled();
+      expect(mockMetrics.incrementTdlibRequests).toHaveBeenCalledWith('getOption', 'success');
+    });
+
+    it('should pass one client id per request for mixed clients', () => {
+      mockAddon.sendBatch = jest.fn().mockReturnValue(3);
+
+      service.sendBatch([
+        { clientId: '1', request: { '@type': 'getMe' } },
+        { clientId: '2', request: { '@type': 'getMe' } },
+        { clientId: '1', request: { '@type': 'getMe' } },
+      ]);
+
+      const [clientArg] = mockAddon.sendBatch.mock.calls[0];
+      expect(clientArg).toBeInstanceOf(Int32Array);
+      expect(Array.from(clientArg as Int32Array)).toEqual([1, 2, 1]);
+    });
+
+    it('should reject the whole batch if a client is unknown', () => {
+      mockAddon.sendBatch = jest.fn();
+
+      expect(() =>
+        service.sendBatch([
+          { clientId: '1', request: { '@type': 'getMe' } },
+          { clientId: 'non-existent', request: { '@type': 'getMe' } },
+        ]),
+      ).toThrow(TdlibClientNotFoundException);
+      expect(mockAddon.sendBatch).not.toHaveBeenCalled();
+    });
+
+    it('should fall back to per-request send without native batch support', () => {
+      const sent = service.sendBatch([
+        { clientId: '1', request: { '@type': 'getMe' } },
+        { clientId: '2', request: { '@type': 'getMe' } },
+      ]);
+
+      expect(sent).toBe(2);
+      expect(mockAddon.send).toHaveBeenCalledTimes(2);
+      expect(mockAddon.send).toHaveBeenCalledWith(2, JSON.stringify({ '@type': 'getMe' }));
+    });
+  });
+
   describe('receive', () => {
     it('should receive update successfully', () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const mockUpdate = { '@type': 'updateNewMessage', message: {} };
-      (service as any).clients.set(clientId, { id: clientId });
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
       mockAddon.receive.mockReturnValue(JSON.stringify(mockUpdate));
 
       const result = service.receive(clientId);
 
       expect(result).toEqual(mockUpdate);
-      expect(mockAddon.receive).toHaveBeenCalledWith(clientId, 1.0);
+      expect(mockAddon.receive).toHaveBeenCalledWith(1.0);
     });
 
     it('should return null when no update available', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
       mockAddon.receive.mockReturnValue(null);
 
       const result = service.receive(clientId);
@@ -237,16 +305,16 @@ describe('TdlibService', () => {
     });
 
     it('should throw TdlibInvalidArgumentException for invalid timeout', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       expect(() => service.receive(clientId, -1)).toThrow(TdlibInvalidArgumentException);
       expect(() => service.receive(clientId, 301)).toThrow(TdlibInvalidArgumentException);
     });
 
     it('should handle JSON parse errors gracefully', () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
       mockAddon.receive.mockReturnValue('invalid json');
 
       const result = service.receive(clientId);
@@ -254,6 +322,138 @@ describe('TdlibService', () => {
       expect(result).toBeNull();
       expect(mockLogger.error).toHaveBeenCalled();
     });
+
+    it('should route updates of other clients to listeners', () => {
+      const clientId = '123';
+      const otherUpdate = { '@type': 'updateOption', name: 'version', '@client_id': 7 };
+      const ownUpdate = { '@type': 'updateNewMessage', message: {}, '@client_id': 123 };
+      const listener = jest.fn();
+      (service as any).responseValidator = { validate: jest.fn().mockReturnValue(true) };
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.receive
+        .mockReturnValueOnce(JSON.stringify(otherUpdate))
+        .mockReturnValueOnce(JSON.stringify(ownUpdate));
+      service.addUpdateListener(listener);
+
+      const result = service.receive(clientId);
+
+      expect(result).toEqual(ownUpdate);
+      expect(mockAddon.receive).toHaveBeenCalledTimes(2);
+      expect(listener).toHaveBeenCalledWith('7', otherUpdate);
+    });
+  });
+
+  describe('update stream', () => {
+    beforeEach(() => {
+      (service as any).responseValidator = { validate: jest.fn().mockReturnValue(true) };
+    });
+
+    it('should start the native receive engine and deliver batches to listeners', () => {
+      const listener = jest.fn();
+      let deliver: (batch: Array<{ clientId: number; update: string }>) => void = () => undefined;
+      mockAddon.startReceiveEngine = jest.fn((callback, options) => {
+        deliver = callback;
+        return options;
+      });
+      mockAddon.stopReceiveEngine = jest.fn();
+
+      service.addUpdateListener(listener);
+      expect(service.startUpdateStream({ maxBatchSize: 64 })).toBe(true);
+      expect(service.isUpdateStreamActive()).toBe(true);
+      expect(mockAddon.startReceiveEngine).toHaveBeenCalledWith(expect.any(Function), { maxBatchSize: 64 });
+
+      deliver([
+        { clientId: 1, update: JSON.stringify({ '@type': 'updateOption', name: 'version' }) },
+        { clientId: 2, update: 'invalid json' },
+      ]);
+
+      expect(listener).toHaveBeenCalledTimes(1);
+      expect(listener).toHaveBeenCalledWith('1', { '@type': 'updateOption', name: 'version' });
+      expect(mockLogger.error).toHaveBeenCalled();
+
+      service.stopUpdateStream();
+      expect(mockAddon.stopReceiveEngine).toHaveBeenCalled();
+      expect(service.isUpdateStreamActive()).toBe(false);
+    });
+
+    it('should report missing engine support', () => {
+      expect(service.supportsUpdateStream()).toBe(false);
+      expect(service.startUpdateStream()).toBe(false);
+    });
+
+    it('should notify listeners from pollUpdates and stop after unsubscribe', () => {
+      const clientId = '123';
+      const mockUpdate = { '@type': 'updateNewMessage', message: {} };
+      const listener = jest.fn();
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.receive.mockReturnValue(JSON.stringify(mockUpdate));
+
+      const unsubscribe = service.addUpdateListener(listener);
+      service.pollUpdates(clientId, 0.5);
+      unsubscribe();
+      service.pollUpdates(clientId, 0.5);
+
+      expect(mockAddon.receive).toHaveBeenCalledWith(0.5);
+      expect(listener).toHaveBeenCalledTimes(1);
+      expect(listener).toHaveBeenCalledWith(clientId, mockUpdate);
+    });
+  });
+
+  describe('update filter', () => {
+    const filter = { mode: 'allow' as const, types: ['updateNewMessage'], coalesce: ['updateUserStatus'] };
+
+    it('should install the default filter on existing and new clients', async () => {
+      mockAddon.setUpdateFilter = jest.fn();
+      (service as any).clients.set('1', { id: '1', nativeId: 1 });
+
+      expect(service.setDefaultUpdateFilter(filter)).toBe(true);
+      expect(mockAddon.setUpdateFilter).toHaveBeenCalledWith(1, filter);
+
+      mockAddon.createClient.mockResolvedValue(2);
+      await service.createClient();
+      expect(mockAddon.setUpdateFilter).toHaveBeenCalledWith(2, filter);
+    });
+
+    it('should report missing filter support', () => {
+      expect(service.supportsUpdateFilter()).toBe(false);
+      expect(service.setDefaultUpdateFilter(filter)).toBe(false);
+      expect(service.getUpdateFilterStats()).toEqual({});
+    });
+
+    it('should throw TdlibClientNotFoundException for non-existent client', () => {
+      mockAddon.setUpdateFilter = jest.fn();
+
+      expect(() => service.setUpdateFilter('non-existent', filter)).toThrow(TdlibClientNotFoundException);
+      expect(mockAddon.setUpdateFilter).not.toHaveBeenCalled();
+    });
+  });
+
+  describe('getNativeMetrics', () => {
+    it('should return the addon metrics snapshot', () => {
+      const latency = { count: 1, sumUs: 120, maxUs: 120, p50Us: 120, p90Us: 120, p99Us: 120, p999Us: 120 };
+      const counters = {
+        requestsSent: 2,
+        responsesReceived: 1,
+        updatesReceived: 5,
+        bytesSent: 64,
+        bytesReceived: 900,
+      };
+      const snapshot = {
+        clients: [{ clientId: 1, status: 'open', ...counters }],
+        totals: counters,
+        pendingRequests: 1,
+        deliveryBacklog: { batches: 0, updates: 0 },
+        responseLatency: latency,
+        lockWait: { engine: latency },
+      };
+      mockAddon.getMetrics = jest.fn().mockReturnValue(snapshot);
+
+      expect(service.getNativeMetrics()).toEqual(snapshot);
+    });
+
+    it('should return null when the addon has no metrics', () => {
+      expect(service.getNativeMetrics()).toBeNull();
+    });
   });
 
   describe('execute', () => {
@@ -285,7 +485,7 @@ describe('TdlibService', () => {
 
   describe('setProxy', () => {
     it('should set proxy successfully', async () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const proxyConfig = {
         type: 'socks5' as const,
         server: '127.0.0.1',
@@ -293,13 +493,13 @@ describe('TdlibService', () => {
         username: 'user',
         password: 'pass',
       };
-      (service as any).clients.set(clientId, { id: clientId });
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       await service.setProxy(clientId, proxyConfig);
 
       expect(mockAddon.send).toHaveBeenCalled();
       const sendCall = mockAddon.send.mock.calls[0];
-      expect(sendCall[0]).toBe(clientId);
+      expect(sendCall[0]).toBe(123);
       const sentRequest = JSON.parse(sendCall[1]);
       expect(sentRequest['@type']).toBe('addProxy');
       expect(sentRequest.server).toBe(proxyConfig.server);
@@ -321,10 +521,10 @@ describe('TdlibService', () => {
 
   describe('sendMessage', () => {
     it('should send message successfully', async () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const chatId = 123456789;
       const message = 'Hello, World!';
-      (service as any).clients.set(clientId, { id: clientId });
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       await service.sendMessage(clientId, chatId, message);
 
@@ -336,8 +536,8 @@ describe('TdlibService', () => {
     });
 
     it('should handle message options', async () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
 
       await service.sendMessage(clientId, 123456789, 'Test', {
         disableNotification: true,
@@ -351,37 +551,279 @@ describe('TdlibService', () => {
     });
   });
 
+  describe('invoke', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).clients.set('123', { id: '123', nativeId: 123 });
+    });
+
+    it('should resolve through the native pending table while the engine runs', async () => {
+      (service as any).updateStreamActive = true;
+      mockAddon.invoke = jest
+        .fn()
+        .mockResolvedValue(JSON.stringify({ '@type': 'ok', '@extra': 'invoke:1', '@client_id': 123 }));
+
+      const response = await service.invoke('123', { '@type': 'getMe', '@extra': 'caller' } as any, 1000);
+
+      expect(response).toEqual({ '@type': 'ok', '@client_id': 123 });
+      expect(mockAddon.invoke).toHaveBeenCalledWith(123, JSON.stringify({ '@type': 'getMe' }), 1000);
+      expect(mockAddon.send).not.toHaveBeenCalled();
+    });
+
+    it('should resolve null when the native request times out', async () => {
+      (service as any).updateStreamActive = true;
+      mockAddon.invoke = jest.fn().mockRejectedValue(Object.assign(new Error('timed out'), { code: 'ETIMEDOUT' }));
+
+      await expect(service.invoke('123', { '@type': 'getMe' } as any, 10)).resolves.toBeNull();
+    });
+
+    it('should match the response by @extra without the receive engine', async () => {
+      const listener = jest.fn();
+      service.addUpdateListener(listener);
+      (service as any).responseValidator = { validate: jest.fn().mockReturnValue(true) };
+      const responses: string[] = [];
+      let extra = '';
+      mockAddon.send.mockImplementation((_clientId: number, json: string) => {
+        extra = JSON.parse(json)['@extra'];
+        responses.push(JSON.stringify({ '@type': 'updateOption', name: 'version', '@client_id': 7 }));
+        responses.push(JSON.stringify({ '@type': 'user', id: 1, '@extra': extra, '@client_id': 123 }));
+      });
+      mockAddon.receive.mockImplementation(() => responses.shift() ?? null);
+
+      const response = await service.invoke('123', { '@type': 'getMe' } as any, 1000);
+
+      expect(response).toEqual({ '@type': 'user', id: 1, '@client_id': 123 });
+      expect(extra).toMatch(/^listener:/);
+      expect(listener).toHaveBeenCalledTimes(1);
+      expect(listener).toHaveBeenCalledWith('7', expect.objectContaining({ '@type': 'updateOption' }));
+    });
+  });
+
+  describe('invokeExpecting', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+      (service as any).clients.set('123', { id: '123', nativeId: 123 });
+    });
+
+    it('should throw TDLib errors', async () => {
+      mockAddon.invoke = jest.fn().mockResolvedValue(JSON.stringify({ '@type': 'error', code: 400, message: 'CHAT_NOT_FOUND' }));
+
+      await expect(service.invokeExpecting('123', { '@type': 'getChat' } as any, 'chat')).rejects.toThrow(
+        'TDLib error: CHAT_NOT_FOUND (code: 400)',
+      );
+    });
+
+    it('should throw on a response of another type', async () => {
+      mockAddon.invoke = jest.fn().mockResolvedValue(JSON.stringify({ '@type': 'ok' }));
+
+      await expect(service.invokeExpecting('123', { '@type': 'getChat' } as any, 'chat')).rejects.toThrow(
+        'Unexpected ok response to getChat',
+      );
+    });
+  });
+
+  describe('rebuildMessageSearchIndex', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+      (service as any).clients.set('123', { id: '123', nativeId: 123 });
+    });
+
+    it('should invoke rebuildMessageSearchIndex and wait for ok', async () => {
+      mockAddon.invoke = jest.fn().mockResolvedValue(JSON.stringify({ '@type': 'ok' }));
+
+      await expect(service.rebuildMessageSearchIndex('123')).resolves.toBeUndefined();
+      expect(mockAddon.invoke).toHaveBeenCalledWith(
+        123,
+        expect.stringContaining('"@type":"rebuildMessageSearchIndex"'),
+        600000,
+      );
+    });
+
+    it('should throw when the message database is not used', async () => {
+      mockAddon.invoke = jest
+        .fn()
+        .mockResolvedValue(JSON.stringify({ '@type': 'error', code: 400, message: "Message database isn't used" }));
+
+      await expect(service.rebuildMessageSearchIndex('123')).rejects.toThrow(
+        "TDLib error: Message database isn't used (code: 400)",
+      );
+    });
+  });
+
+  describe('waitForUpdate', () => {
+    it('should resolve with the first matching update of the client', async () => {
+      const waiting = service.waitForUpdate('123', (update) => update['@type'] === 'updateAuthorizationState', 1000);
+
+      (service as any).emitUpdate('7', { '@type': 'updateAuthorizationState' });
+      (service as any).emitUpdate('123', { '@type': 'updateOption' });
+      (service as any).emitUpdate('123', { '@type': 'updateAuthorizationState', authorization_state: {} });
+
+      await expect(waiting).resolves.toEqual({ '@type': 'updateAuthorizationState', authorization_state: {} });
+      expect((service as any).updateListeners.size).toBe(0);
+    });
+
+    it('should resolve null on timeout', async () => {
+      await expect(service.waitForUpdate('123', () => true, 10)).resolves.toBeNull();
+      expect((service as any).updateListeners.size).toBe(0);
+    });
+  });
+
+  describe('sendMessageAndWait', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+      (service as any).clients.set('123', { id: '123', nativeId: 123 });
+    });
+
+    it('should resolve with the sent message, also if the result came with the response', async () => {
+      mockAddon.invoke = jest.fn().mockImplementation(async () => {
+        (service as any).emitUpdate('123', {
+          '@type': 'updateMessageSendSucceeded',
+          old_message_id: 1,
+          message: { '@type': 'message', id: 100 },
+        });
+        return JSON.stringify({ '@type': 'message', id: 1, sending_state: { '@type': 'messageSendingStatePending' } });
+      });
+
+      await expect(service.sendMessageAndWait('123', 42, 'Hi')).resolves.toEqual({ '@type': 'message', id: 100 });
+    });
+
+    it('should resolve with an error when sending failed', async () => {
+      mockAddon.invoke = jest
+        .fn()
+        .mockResolvedValue(
+          JSON.stringify({ '@type': 'message', id: 1, sending_state: { '@type': 'messageSendingStatePending' } }),
+        );
+
+      const sending = service.sendMessageAndWait('123', 42, 'Hi');
+      await new Promise((resolve) => setImmediate(resolve));
+      (service as any).emitUpdate('123', {
+        '@type': 'updateMessageSendFailed',
+        old_message_id: 1,
+        error: { '@type': 'error', code: 429, message: 'FLOOD_WAIT_5' },
+      });
+
+      await expect(sending).resolves.toEqual({ '@type': 'error', code: 429, message: 'FLOOD_WAIT_5' });
+    });
+  });
+
+  describe('sendPaced', () => {
+    let deliver: (results: any[]) => void = () => undefined;
+
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).clients.set('123', { id: '123', nativeId: 123 });
+      mockAddon.startReceiveEngine = jest.fn((_callback, options) => options);
+      mockAddon.stopReceiveEngine = jest.fn();
+      mockAddon.startSendPacer = jest.fn((callback, options) => {
+        deliver = callback;
+        return options;
+      });
+      mockAddon.stopSendPacer = jest.fn();
+      mockAddon.enqueueSends = jest.fn().mockReturnValue(5);
+      mockAddon.cancelSends = jest.fn().mockReturnValue(1);
+      service.startUpdateStream();
+    });
+
+    it('should queue requests natively and resolve once every result is reported', async () => {
+      const onResults = jest.fn();
+      const { batchId, done } = service.sendPaced(
+        '123',
+        [
+          { '@type': 'sendMessage', chat_id: 1, '@extra': 'caller' } as any,
+          { '@type': 'sendMessage', chat_id: 2 } as any,
+        ],
+        { pacing: { ratePerSecond: 5, burst: 2 }, onResults },
+      );
+
+      expect(batchId).toBe(5);
+      expect(mockAddon.startSendPacer).toHaveBeenCalledWith(expect.any(Function), {});
+      expect(mockAddon.enqueueSends).toHaveBeenCalledWith(
+        123,
+        [JSON.stringify({ '@type': 'sendMessage', chat_id: 1 }), JSON.stringify({ '@type': 'sendMessage', chat_id: 2 })],
+        { ratePerSecond: 5, burst: 2 },
+      );
+
+      const response = { '@type': 'updateMessageSendSucceeded', old_message_id: 1, '@client_id': 123 };
+      deliver([
+        { batchId: 5, index: 0, clientId: 123, status: 'sent', attempts: 2, response: JSON.stringify(response) },
+        { batchId: 4, index: 0, clientId: 123, status: 'cancelled', attempts: 0 },
+      ]);
+      expect(onResults).toHaveBeenCalledWith([
+        { batchId: 5, index: 0, clientId: '123', status: 'sent', attempts: 2, response },
+      ]);
+
+      deliver([
+        {
+          batchId: 5,
+          index: 1,
+          clientId: 123,
+          status: 'failed',
+          attempts: 1,
+          errorCode: 403,
+          errorMessage: 'CHAT_WRITE_FORBIDDEN',
+        },
+      ]);
+      await expect(done).resolves.toEqual({ batchId: 5, sent: 1, failed: 1, timedOut: 0, cancelled: 0 });
+      expect(mockMetrics.incrementTdlibErrors).toHaveBeenCalledWith('paced_send_failed', 403);
+      expect(service.cancelPacedSends(5)).toBe(1);
+    });
+
+    it('should stop the pacer with the receive engine', () => {
+      service.sendPaced('123', []);
+      service.stopUpdateStream();
+
+      expect(mockAddon.stopSendPacer).toHaveBeenCalled();
+      expect(mockAddon.stopReceiveEngine).toHaveBeenCalled();
+      expect(service.cancelPacedSends(5)).toBe(0);
+    });
+
+    it('should report missing pacer support', () => {
+      mockAddon.enqueueSends = undefined;
+
+      expect(service.supportsSendPacing()).toBe(false);
+      expect(() => service.sendPaced('123', [])).toThrow(TdlibNotReadyException);
+    });
+
+    it('should not start the receive engine for paced sends', () => {
+      service.stopUpdateStream();
+      mockAddon.startReceiveEngine.mockClear();
+
+      expect(service.supportsSendPacing()).toBe(false);
+      expect(() => service.sendPaced('123', [])).toThrow(TdlibNotReadyException);
+      expect(mockAddon.startReceiveEngine).not.toHaveBeenCalled();
+    });
+  });
+
   describe('getMe', () => {
+    beforeEach(() => {
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+    });
+
     it('should get account info successfully', async () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const mockUser = {
         '@type': 'user',
         id: 123456789,
         first_name: 'Test',
         username: 'testuser',
       };
-      (service as any).clients.set(clientId, { id: clientId });
-
-      // Mock receive to return user after getMe
-      let receiveCallCount = 0;
-      mockAddon.receive.mockImplementation(() => {
-        receiveCallCount++;
-        if (receiveCallCount === 1) {
-          return JSON.stringify(mockUser);
-        }
-        return null;
-      });
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.invoke = jest.fn().mockResolvedValue(JSON.stringify(mockUser));
 
       const result = await service.getMe(clientId);
 
       expect(result).toEqual(mockUser);
-      expect(mockAddon.send).toHaveBeenCalled();
+      expect(mockAddon.invoke).toHaveBeenCalledWith(123, JSON.stringify({ '@type': 'getMe' }), 5000);
     });
 
     it('should throw timeout error when no response', async () => {
-      const clientId = 'client-123';
-      (service as any).clients.set(clientId, { id: clientId });
-      mockAddon.receive.mockReturnValue(null);
+      const clientId = '123';
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.invoke = jest.fn().mockRejectedValue(Object.assign(new Error('timed out'), { code: 'ETIMEDOUT' }));
 
       await expect(service.getMe(clientId)).rejects.toThrow('Timeout waiting for getMe response');
     });
@@ -389,52 +831,55 @@ describe('TdlibService', () => {
 
   describe('getChats', () => {
     it('should get chats successfully', async () => {
-      const clientId = 'client-123';
-      const mockChat = {
-        '@type': 'chat',
-        id: 123456789,
-        title: 'Test Chat',
-      };
-      (service as any).clients.set(clientId, { id: clientId });
-
-      let receiveCallCount = 0;
-      mockAddon.receive.mockImplementation(() => {
-        receiveCallCount++;
-        if (receiveCallCount <= 2) {
-          return JSON.stringify(mockChat);
+      const clientId = '123';
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.invoke = jest.fn().mockImplementation(async (_clientId: number, json: string) => {
+        const request = JSON.parse(json);
+        if (request['@type'] === 'getChats') {
+          return JSON.stringify({ '@type': 'chats', total_count: 3, chat_ids: [1, 2, 3] });
         }
-        return null;
+        if (request.chat_id === 3) {
+          return JSON.stringify({ '@type': 'error', code: 400, message: 'Chat not found' });
+        }
+        return JSON.stringify({ '@type': 'chat', id: request.chat_id, title: `Chat ${request.chat_id}` });
       });
 
       const result = await service.getChats(clientId, 10, 0);
 
-      expect(result.length).toBeGreaterThan(0);
-      expect(mockAddon.send).toHaveBeenCalled();
+      expect(result).toEqual([
+        { '@type': 'chat', id: 1, title: 'Chat 1' },
+        { '@type': 'chat', id: 2, title: 'Chat 2' },
+      ]);
     });
   });
 
   describe('searchContacts', () => {
     it('should search contacts successfully', async () => {
-      const clientId = 'client-123';
+      const clientId = '123';
       const mockUsers = {
         '@type': 'users',
         user_ids: [123, 456],
       };
-      (service as any).clients.set(clientId, { id: clientId });
-
-      mockAddon.receive.mockReturnValue(JSON.stringify(mockUsers));
+      (service as any).requestValidator = { validate: jest.fn() };
+      (service as any).updateStreamActive = true;
+      (service as any).clients.set(clientId, { id: clientId, nativeId: Number(clientId) });
+      mockAddon.invoke = jest.fn().mockResolvedValue(JSON.stringify(mockUsers));
 
       const result = await service.searchContacts(clientId, 'test');
 
-      expect(mockAddon.send).toHaveBeenCalled();
-      // Note: The current implementation returns user_ids array, not full user objects
+      expect(result).toEqual([
+        { '@type': 'user', id: 123 },
+        { '@type': 'user', id: 456 },
+      ]);
     });
   });
 
   describe('getClientCount', () => {
     it('should return correct client count', () => {
-      (service as any).clients.set('client-1', { id: 'client-1' });
-      (service as any).clients.set('client-2', { id: 'client-2' });
+      (service as any).clients.set('1', { id: '1', nativeId: 1 });
+      (service as any).clients.set('2', { id: '2', nativeId: 2 });
 
       expect(service.getClientCount()).toBe(2);
     });
@@ -442,12 +887,12 @@ describe('TdlibService', () => {
 
   describe('getAllClientIds', () => {
     it('should return all client IDs', () => {
-      (service as any).clients.set('client-1', { id: 'client-1' });
-      (service as any).clients.set('client-2', { id: 'client-2' });
+      (service as any).clients.set('1', { id: '1', nativeId: 1 });
+      (service as any).clients.set('2', { id: '2', nativeId: 2 });
 
       const ids = service.getAllClientIds();
-      expect(ids).toContain('client-1');
-      expect(ids).toContain('client-2');
+      expect(ids).toContain('1');
+      expect(ids).toContain('2');
       expect(ids.length).toBe(2);
     });
   });